@@ -19,6 +19,78 @@
 */
 #include <I2cMaster.h>
 #include <TwiMap.h>
+//------------------------------------------------------------------------------
+/**
+    Begin an operation. This default completes it at once by calling the
+    blocking primitive, so ready() is always true.
+
+    \param[in] op One of I2C_OP_START, I2C_OP_RESTART, I2C_OP_WRITE,
+    I2C_OP_READ or I2C_OP_STOP.
+
+    \param[in] data Address with read/write bit, byte to write or last flag.
+*/
+void I2cMasterBase::post(uint8_t op, uint8_t data) {
+    switch (op) {
+        case I2C_OP_START:
+            result_ = start(data);
+            break;
+        case I2C_OP_RESTART:
+            result_ = restart(data);
+            break;
+        case I2C_OP_WRITE:
+            result_ = write(data);
+            break;
+        case I2C_OP_READ:
+            result_ = read(data);
+            break;
+        default:
+            stop();
+            result_ = true;
+            break;
+    }
+}
+//------------------------------------------------------------------------------
+/**
+    Write then read as one transaction, with the byte primitives.
+
+    \param[in] address 7-bit slave address.
+
+    \param[in] tx Bytes to write, may be null if txLen is zero.
+
+    \param[in] txLen Number of bytes to write.
+
+    \param[out] rx Buffer for the bytes read, may be null if rxLen is zero.
+
+    \param[in] rxLen Number of bytes to read, zero for a write only.
+
+    \param[in] first Open with a start, else with a repeated start.
+
+    \param[in] last Close with a stop, else keep the bus.
+
+    \return The value true if the slave acked, else false with the bus
+    stopped.
+*/
+bool I2cMasterBase::transfer(uint8_t address, const uint8_t* tx, uint8_t txLen,
+                             uint8_t* rx, uint8_t rxLen, bool first, bool last) {
+    // a read only transaction addresses the slave for reading at once
+    uint8_t addressRW = address << 1 | (txLen || !rxLen ? I2C_WRITE : I2C_READ);
+    bool ack = first ? start(addressRW) : restart(addressRW);
+    while (ack && txLen) {
+        ack = write(*tx++);
+        txLen--;
+    }
+    if (ack && rxLen && !(addressRW & I2C_READ)) {
+        ack = restart(address << 1 | I2C_READ);
+    }
+    while (ack && rxLen) {
+        rxLen--;
+        *rx++ = read(rxLen == 0);
+    }
+    if (!ack || last) {
+        stop();
+    }
+    return ack;
+}
 //==============================================================================
 // WARNING don't change SoftI2cMaster unless you verify the change with a scope
 //------------------------------------------------------------------------------
@@ -45,6 +117,7 @@ SoftI2cMaster::SoftI2cMaster(uint8_t sdaPin, uint8_t sclPin) {
     \return The byte read from the I2C bus.
 */
 uint8_t SoftI2cMaster::read(uint8_t last) {
+    I2C_TRACE_BEGIN();
     uint8_t b = 0;
     // make sure pull-up enabled
     digitalWrite(sdaPin_, HIGH);
@@ -67,6 +140,7 @@ uint8_t SoftI2cMaster::read(uint8_t last) {
     delayMicroseconds(I2C_DELAY_USEC);
     digitalWrite(sclPin_, LOW);
     digitalWrite(sdaPin_, LOW);
+    I2C_TRACE_END(I2C_PHASE_DATA, true);
     return b;
 }
 //------------------------------------------------------------------------------
@@ -90,20 +164,25 @@ bool SoftI2cMaster::restart(uint8_t addressRW) {
     \return The value true, 1, for success or false, 0, for failure.
 */
 bool SoftI2cMaster::start(uint8_t addressRW) {
+    I2C_TRACE_BEGIN();
     digitalWrite(sdaPin_, LOW);
     delayMicroseconds(I2C_DELAY_USEC);
     digitalWrite(sclPin_, LOW);
+    I2C_TRACE_END(I2C_PHASE_START, true);
+    I2C_TRACE_NEXT(I2C_PHASE_ADDRESS);
     return write(addressRW);
 }
 //------------------------------------------------------------------------------
 /**  Issue a stop condition. */
 void SoftI2cMaster::stop(void) {
+    I2C_TRACE_BEGIN();
     digitalWrite(sdaPin_, LOW);
     delayMicroseconds(I2C_DELAY_USEC);
     digitalWrite(sclPin_, HIGH);
     delayMicroseconds(I2C_DELAY_USEC);
     digitalWrite(sdaPin_, HIGH);
     delayMicroseconds(I2C_DELAY_USEC);
+    I2C_TRACE_END(I2C_PHASE_STOP, true);
 }
 //------------------------------------------------------------------------------
 /**
@@ -114,6 +193,7 @@ void SoftI2cMaster::stop(void) {
     \return The value true, 1, if the slave returned an Ack or false for Nak.
 */
 bool SoftI2cMaster::write(uint8_t data) {
+    I2C_TRACE_BEGIN();
     // write byte
     for (uint8_t m = 0X80; m != 0; m >>= 1) {
         // don't change this loop unless you verify the change with a scope
@@ -132,8 +212,514 @@ bool SoftI2cMaster::write(uint8_t data) {
     digitalWrite(sclPin_, LOW);
     pinMode(sdaPin_, OUTPUT);
     digitalWrite(sdaPin_, LOW);
+    I2C_TRACE_END(I2C_PHASE_DATA, rtn == 0);
+    return rtn == 0;
+}
+//------------------------------------------------------------------------------
+/**
+    Hold SCL low or release it, with the bus idle.
+
+    \param[in] low Set true to pull SCL low, false to set it high again.
+*/
+void SoftI2cMaster::holdScl(bool low) {
+    digitalWrite(sclPin_, low ? LOW : HIGH);
+}
+//------------------------------------------------------------------------------
+/**
+    Clock SCL until the slave holding SDA low releases it, then issue a
+    stop.
+
+    \return The value true if SDA is high again.
+*/
+bool SoftI2cMaster::recover(void) {
+    // release SDA, with pull-up
+    pinMode(sdaPin_, INPUT);
+    digitalWrite(sdaPin_, HIGH);
+    for (uint8_t i = 0; i < I2C_RECOVER_CLOCKS && !digitalRead(sdaPin_); i++) {
+        digitalWrite(sclPin_, LOW);
+        delayMicroseconds(I2C_DELAY_USEC);
+        digitalWrite(sclPin_, HIGH);
+        delayMicroseconds(I2C_DELAY_USEC);
+    }
+    bool released = digitalRead(sdaPin_);
+    digitalWrite(sclPin_, LOW);
+    pinMode(sdaPin_, OUTPUT);
+    stop();
+    return released;
+}
+//==============================================================================
+/**
+    Resolve the pins, set the clock and set the bus high.
+
+    \param[in] sdaPin The software SDA pin number.
+
+    \param[in] sclPin The software SCL pin number.
+
+    \param[in] sclHz Target SCL frequency. The actual one is lower, by the
+    time spent toggling pins.
+*/
+FastSoftI2cMaster::FastSoftI2cMaster(uint8_t sdaPin, uint8_t sclPin, uint32_t sclHz) {
+    #if defined(ARDUINO_ARCH_AVR)
+    sdaOut_ = portOutputRegister(digitalPinToPort(sdaPin));
+    sdaIn_ = portInputRegister(digitalPinToPort(sdaPin));
+    sdaDdr_ = portModeRegister(digitalPinToPort(sdaPin));
+    sdaMask_ = digitalPinToBitMask(sdaPin);
+    sclOut_ = portOutputRegister(digitalPinToPort(sclPin));
+    sclMask_ = digitalPinToBitMask(sclPin);
+    #else
+    sdaPin_ = sdaPin;
+    sclPin_ = sclPin;
+    #endif
+    setClock(sclHz);
+    pinMode(sdaPin, OUTPUT);
+    digitalWrite(sdaPin, HIGH);
+    pinMode(sclPin, OUTPUT);
+    digitalWrite(sclPin, HIGH);
+}
+//------------------------------------------------------------------------------
+/**
+    Set the SCL frequency.
+
+    \param[in] sclHz Target frequency. The half bit is rounded up to whole
+    microseconds, so the frequency is rounded down and never exceeded.
+    The half bit is at most 255 microseconds: below 1961 Hz, and for 0,
+    the clock is that slowest one.
+*/
+void FastSoftI2cMaster::setClock(uint32_t sclHz) {
+    uint32_t half = sclHz ? (500000UL + sclHz - 1) / sclHz : 255;
+    halfBitUsec_ = half > 255 ? 255 : half;
+}
+//------------------------------------------------------------------------------
+#if defined(ARDUINO_ARCH_AVR)
+void FastSoftI2cMaster::sclWrite(uint8_t level) {
+    uint8_t oldSREG = SREG;
+    cli();
+    if (level) {
+        *sclOut_ |= sclMask_;
+    } else {
+        *sclOut_ &= ~sclMask_;
+    }
+    SREG = oldSREG;
+}
+void FastSoftI2cMaster::sdaWrite(uint8_t level) {
+    uint8_t oldSREG = SREG;
+    cli();
+    if (level) {
+        *sdaOut_ |= sdaMask_;
+    } else {
+        *sdaOut_ &= ~sdaMask_;
+    }
+    SREG = oldSREG;
+}
+void FastSoftI2cMaster::sdaMode(uint8_t mode) {
+    uint8_t oldSREG = SREG;
+    cli();
+    if (mode == OUTPUT) {
+        *sdaDdr_ |= sdaMask_;
+    } else {
+        *sdaDdr_ &= ~sdaMask_;
+    }
+    SREG = oldSREG;
+}
+uint8_t FastSoftI2cMaster::sdaRead(void) {
+    return (*sdaIn_ & sdaMask_) != 0;
+}
+#else  // ARDUINO_ARCH_AVR
+void FastSoftI2cMaster::sclWrite(uint8_t level) {
+    digitalWrite(sclPin_, level);
+}
+void FastSoftI2cMaster::sdaWrite(uint8_t level) {
+    digitalWrite(sdaPin_, level);
+}
+void FastSoftI2cMaster::sdaMode(uint8_t mode) {
+    pinMode(sdaPin_, mode);
+}
+uint8_t FastSoftI2cMaster::sdaRead(void) {
+    return digitalRead(sdaPin_);
+}
+#endif  // ARDUINO_ARCH_AVR
+//------------------------------------------------------------------------------
+/** Read a byte and send Ack if more reads follow else Nak to terminate read.
+
+    \param[in] last Set true to terminate the read else false.
+
+    \return The byte read from the I2C bus.
+*/
+uint8_t FastSoftI2cMaster::read(uint8_t last) {
+    I2C_TRACE_BEGIN();
+    uint8_t b = 0;
+    // make sure pull-up enabled
+    sdaWrite(HIGH);
+    sdaMode(INPUT);
+    // read byte
+    for (uint8_t i = 0; i < 8; i++) {
+        b <<= 1;
+        halfBit();
+        sclWrite(HIGH);
+        halfBit();
+        if (sdaRead()) {
+            b |= 1;
+        }
+        sclWrite(LOW);
+    }
+    // send Ack or Nak
+    sdaMode(OUTPUT);
+    sdaWrite(last);
+    halfBit();
+    sclWrite(HIGH);
+    halfBit();
+    sclWrite(LOW);
+    sdaWrite(LOW);
+    I2C_TRACE_END(I2C_PHASE_DATA, true);
+    return b;
+}
+//------------------------------------------------------------------------------
+/** Issue a restart condition.
+
+    \param[in] addressRW I2C address with read/write bit.
+
+    \return The value true, 1, for success or false, 0, for failure.
+*/
+bool FastSoftI2cMaster::restart(uint8_t addressRW) {
+    sdaWrite(HIGH);
+    halfBit();
+    sclWrite(HIGH);
+    halfBit();
+    return start(addressRW);
+}
+//------------------------------------------------------------------------------
+/** Issue a start condition.
+
+    \param[in] addressRW I2C address with read/write bit.
+
+    \return The value true, 1, for success or false, 0, for failure.
+*/
+bool FastSoftI2cMaster::start(uint8_t addressRW) {
+    I2C_TRACE_BEGIN();
+    sdaWrite(LOW);
+    halfBit();
+    sclWrite(LOW);
+    I2C_TRACE_END(I2C_PHASE_START, true);
+    I2C_TRACE_NEXT(I2C_PHASE_ADDRESS);
+    return write(addressRW);
+}
+//------------------------------------------------------------------------------
+/**  Issue a stop condition. */
+void FastSoftI2cMaster::stop(void) {
+    I2C_TRACE_BEGIN();
+    sdaWrite(LOW);
+    halfBit();
+    sclWrite(HIGH);
+    halfBit();
+    sdaWrite(HIGH);
+    halfBit();
+    I2C_TRACE_END(I2C_PHASE_STOP, true);
+}
+//------------------------------------------------------------------------------
+/**
+    Write a byte.
+
+    \param[in] data The byte to send.
+
+    \return The value true, 1, if the slave returned an Ack or false for Nak.
+*/
+bool FastSoftI2cMaster::write(uint8_t data) {
+    I2C_TRACE_BEGIN();
+    // write byte
+    for (uint8_t m = 0X80; m != 0; m >>= 1) {
+        sdaWrite(m & data);
+        halfBit();
+        sclWrite(HIGH);
+        halfBit();
+        sclWrite(LOW);
+    }
+
+    // get Ack or Nak
+    sdaMode(INPUT);
+    // enable pullup
+    sdaWrite(HIGH);
+    halfBit();
+    sclWrite(HIGH);
+    halfBit();
+    uint8_t rtn = sdaRead();
+    sclWrite(LOW);
+    sdaMode(OUTPUT);
+    sdaWrite(LOW);
+    I2C_TRACE_END(I2C_PHASE_DATA, rtn == 0);
     return rtn == 0;
 }
+//------------------------------------------------------------------------------
+/**
+    Clock SCL until the slave holding SDA low releases it, then issue a
+    stop.
+
+    \return The value true if SDA is high again.
+*/
+bool FastSoftI2cMaster::recover(void) {
+    // release SDA, with pull-up
+    sdaMode(INPUT);
+    sdaWrite(HIGH);
+    for (uint8_t i = 0; i < I2C_RECOVER_CLOCKS && !sdaRead(); i++) {
+        sclWrite(LOW);
+        halfBit();
+        sclWrite(HIGH);
+        halfBit();
+    }
+    bool released = sdaRead();
+    sclWrite(LOW);
+    sdaMode(OUTPUT);
+    stop();
+    return released;
+}
+//------------------------------------------------------------------------------
+/**
+    Hold SCL low or release it, with the bus idle.
+
+    \param[in] low Set true to pull SCL low, false to set it high again.
+*/
+void FastSoftI2cMaster::holdScl(bool low) {
+    sclWrite(low ? LOW : HIGH);
+}
+//==============================================================================
+/**
+    Set up the shared SCL pin and every SDA pin, and set the buses high.
+
+    \param[in] sdaPins The SDA pin of each bus, bus 0 first.
+
+    \param[in] count Number of buses, 1 to I2C_MULTI_MAX_BUSES; clamped to
+    that range, so sdaPins must hold at least one pin.
+
+    \param[in] sclPin The SCL pin shared by all buses.
+
+    \param[in] sclHz Target SCL frequency.
+*/
+SoftI2cMultiMaster::SoftI2cMultiMaster(const uint8_t* sdaPins, uint8_t count,
+                                       uint8_t sclPin, uint32_t sclHz) {
+    count_ = count > I2C_MULTI_MAX_BUSES ? I2C_MULTI_MAX_BUSES : count < 1 ? 1 : count;
+    sclPin_ = sclPin;
+    for (uint8_t i = 0; i < count_; i++) {
+        sdaPins_[i] = sdaPins[i];
+        pinMode(sdaPins_[i], OUTPUT);
+        digitalWrite(sdaPins_[i], HIGH);
+    }
+    pinMode(sclPin_, OUTPUT);
+    digitalWrite(sclPin_, HIGH);
+    setClock(sclHz);
+    #if defined(ARDUINO_ARCH_AVR)
+    sclOut_ = portOutputRegister(digitalPinToPort(sclPin));
+    sclMask_ = digitalPinToBitMask(sclPin);
+    uint8_t port = digitalPinToPort(sdaPins_[0]);
+    samePort_ = true;
+    sdaMask_ = 0;
+    for (uint8_t i = 0; i < count_; i++) {
+        samePort_ = samePort_ && digitalPinToPort(sdaPins_[i]) == port;
+        laneMask_[i] = digitalPinToBitMask(sdaPins_[i]);
+        sdaMask_ |= laneMask_[i];
+    }
+    sdaOut_ = portOutputRegister(port);
+    sdaIn_ = portInputRegister(port);
+    sdaDdr_ = portModeRegister(port);
+    #endif  // ARDUINO_ARCH_AVR
+}
+//------------------------------------------------------------------------------
+/**
+    Set the SCL frequency.
+
+    \param[in] sclHz Target frequency, rounded down as the half bit is
+    rounded up to whole microseconds. The half bit is at most 255
+    microseconds: below 1961 Hz, and for 0, the clock is that slowest one.
+*/
+void SoftI2cMultiMaster::setClock(uint32_t sclHz) {
+    uint32_t half = sclHz ? (500000UL + sclHz - 1) / sclHz : 255;
+    halfBitUsec_ = half > 255 ? 255 : half;
+}
+//------------------------------------------------------------------------------
+#if defined(ARDUINO_ARCH_AVR)
+void SoftI2cMultiMaster::sclWrite(uint8_t level) {
+    uint8_t oldSREG = SREG;
+    cli();
+    if (level) {
+        *sclOut_ |= sclMask_;
+    } else {
+        *sclOut_ &= ~sclMask_;
+    }
+    SREG = oldSREG;
+}
+void SoftI2cMultiMaster::sdaWrite(uint8_t level) {
+    if (!samePort_) {
+        for (uint8_t i = 0; i < count_; i++) {
+            digitalWrite(sdaPins_[i], level);
+        }
+        return;
+    }
+    uint8_t oldSREG = SREG;
+    cli();
+    if (level) {
+        *sdaOut_ |= sdaMask_;
+    } else {
+        *sdaOut_ &= ~sdaMask_;
+    }
+    SREG = oldSREG;
+}
+void SoftI2cMultiMaster::sdaMode(uint8_t mode) {
+    if (!samePort_) {
+        for (uint8_t i = 0; i < count_; i++) {
+            pinMode(sdaPins_[i], mode);
+        }
+        return;
+    }
+    uint8_t oldSREG = SREG;
+    cli();
+    if (mode == OUTPUT) {
+        *sdaDdr_ |= sdaMask_;
+    } else {
+        *sdaDdr_ &= ~sdaMask_;
+    }
+    SREG = oldSREG;
+}
+uint8_t SoftI2cMultiMaster::sdaRead(void) {
+    uint8_t lanes = 0;
+    if (samePort_) {
+        // one sample of the port for all buses
+        uint8_t port = *sdaIn_;
+        for (uint8_t i = 0; i < count_; i++) {
+            if (port & laneMask_[i]) {
+                lanes |= 1 << i;
+            }
+        }
+    } else {
+        for (uint8_t i = 0; i < count_; i++) {
+            if (digitalRead(sdaPins_[i])) {
+                lanes |= 1 << i;
+            }
+        }
+    }
+    return lanes;
+}
+#else  // ARDUINO_ARCH_AVR
+void SoftI2cMultiMaster::sclWrite(uint8_t level) {
+    digitalWrite(sclPin_, level);
+}
+void SoftI2cMultiMaster::sdaWrite(uint8_t level) {
+    for (uint8_t i = 0; i < count_; i++) {
+        digitalWrite(sdaPins_[i], level);
+    }
+}
+void SoftI2cMultiMaster::sdaMode(uint8_t mode) {
+    for (uint8_t i = 0; i < count_; i++) {
+        pinMode(sdaPins_[i], mode);
+    }
+}
+uint8_t SoftI2cMultiMaster::sdaRead(void) {
+    uint8_t lanes = 0;
+    for (uint8_t i = 0; i < count_; i++) {
+        if (digitalRead(sdaPins_[i])) {
+            lanes |= 1 << i;
+        }
+    }
+    return lanes;
+}
+#endif  // ARDUINO_ARCH_AVR
+//------------------------------------------------------------------------------
+/** Read one byte from every bus and send Ack if more reads follow else Nak.
+
+    \param[in] last Set true to terminate the read else false.
+
+    \param[out] data One byte per bus, count() bytes.
+*/
+void SoftI2cMultiMaster::read(uint8_t last, uint8_t* data) {
+    for (uint8_t i = 0; i < count_; i++) {
+        data[i] = 0;
+    }
+    // make sure pull-ups enabled
+    sdaWrite(HIGH);
+    sdaMode(INPUT);
+    // read byte, one bit of every bus per clock
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        halfBit();
+        sclWrite(HIGH);
+        halfBit();
+        uint8_t lanes = sdaRead();
+        sclWrite(LOW);
+        for (uint8_t i = 0; i < count_; i++) {
+            data[i] = data[i] << 1 | ((lanes >> i) & 1);
+        }
+    }
+    // send Ack or Nak
+    sdaMode(OUTPUT);
+    sdaWrite(last);
+    halfBit();
+    sclWrite(HIGH);
+    halfBit();
+    sclWrite(LOW);
+    sdaWrite(LOW);
+}
+//------------------------------------------------------------------------------
+/** Issue a restart condition on all buses.
+
+    \param[in] addressRW I2C address with read/write bit.
+
+    \return Mask of the buses that returned an Ack.
+*/
+uint8_t SoftI2cMultiMaster::restart(uint8_t addressRW) {
+    sdaWrite(HIGH);
+    halfBit();
+    sclWrite(HIGH);
+    halfBit();
+    return start(addressRW);
+}
+//------------------------------------------------------------------------------
+/** Issue a start condition on all buses.
+
+    \param[in] addressRW I2C address with read/write bit.
+
+    \return Mask of the buses that returned an Ack.
+*/
+uint8_t SoftI2cMultiMaster::start(uint8_t addressRW) {
+    sdaWrite(LOW);
+    halfBit();
+    sclWrite(LOW);
+    return write(addressRW);
+}
+//------------------------------------------------------------------------------
+/**  Issue a stop condition on all buses. */
+void SoftI2cMultiMaster::stop(void) {
+    sdaWrite(LOW);
+    halfBit();
+    sclWrite(HIGH);
+    halfBit();
+    sdaWrite(HIGH);
+    halfBit();
+}
+//------------------------------------------------------------------------------
+/**
+    Write the same byte to all buses.
+
+    \param[in] data The byte to send.
+
+    \return Mask of the buses that returned an Ack.
+*/
+uint8_t SoftI2cMultiMaster::write(uint8_t data) {
+    for (uint8_t m = 0X80; m != 0; m >>= 1) {
+        sdaWrite(m & data);
+        halfBit();
+        sclWrite(HIGH);
+        halfBit();
+        sclWrite(LOW);
+    }
+
+    // get Ack or Nak of every bus
+    sdaMode(INPUT);
+    sdaWrite(HIGH);
+    halfBit();
+    sclWrite(HIGH);
+    halfBit();
+    uint8_t naks = sdaRead();
+    sclWrite(LOW);
+    sdaMode(OUTPUT);
+    sdaWrite(LOW);
+    return ~naks & all();
+}
 //==============================================================================
 
 #if defined(ARDUINO_ARCH_AVR)
@@ -142,11 +728,27 @@ void TwiMaster::execCmd(uint8_t cmdReg) {
     // send command
     TWCR = cmdReg;
     // wait for command to complete
-    while (!(TWCR & (1 << TWINT)));
+    uint32_t t0 = micros();
+    while (!(TWCR & (1 << TWINT))) {
+        if (micros() - t0 > I2C_TIMEOUT_USEC) {
+            timeout();
+            return;
+        }
+    }
     // status bits.
     status_ = TWSR & 0xF8;
 }
 //------------------------------------------------------------------------------
+/** Reset the TWI after a command that did not complete. */
+void TwiMaster::timeout(void) {
+    TWCR = 0;
+    TWCR = (1 << TWEN);
+    status_ = TWSR_TIMEOUT;
+}
+//------------------------------------------------------------------------------
+// Internal post() phases besides I2C_OP_*
+uint8_t const TWI_OP_ADDRESS = 0X10;
+uint8_t const TWI_OP_DONE = 0XFF;
 /**
     Initialize hardware TWI.
 
@@ -154,10 +756,13 @@ void TwiMaster::execCmd(uint8_t cmdReg) {
     pull-ups can, in some systems, eliminate the need for external pull-ups.
 */
 TwiMaster::TwiMaster(bool enablePullup) {
+    // nothing posted yet: ready() is true before the first post()
+    op_ = TWI_OP_DONE;
+    posted_ = 0;
+    pullup_ = enablePullup;
     // no prescaler
     TWSR = 0;
-    // set bit rate factor
-    TWBR = (F_CPU / F_TWI - 16) / 2;
+    setClock(F_TWI);
     // enable pull-ups if requested
     if (enablePullup) {
         digitalWrite(TWI_SDA_PIN, HIGH);
@@ -165,6 +770,18 @@ TwiMaster::TwiMaster(bool enablePullup) {
     }
 }
 //------------------------------------------------------------------------------
+/**
+    Set the SCL frequency.
+
+    \param[in] sclHz SCL frequency in Hz, down to F_CPU / 526 (about 30 kHz
+    at 16 MHz).
+*/
+void TwiMaster::setClock(uint32_t sclHz) {
+    // set bit rate factor
+    uint32_t twbr = (F_CPU / sclHz - 16) / 2;
+    TWBR = twbr > 255 ? 255 : twbr;
+}
+//------------------------------------------------------------------------------
 /** Read a byte and send Ack if more reads follow else Nak to terminate read.
 
     \param[in] last Set true to terminate the read else false.
@@ -172,7 +789,9 @@ TwiMaster::TwiMaster(bool enablePullup) {
     \return The byte read from the I2C bus.
 */
 uint8_t TwiMaster::read(uint8_t last) {
+    I2C_TRACE_BEGIN();
     execCmd((1 << TWINT) | (1 << TWEN) | (last ? 0 : (1 << TWEA)));
+    I2C_TRACE_END(I2C_PHASE_DATA, status() != TWSR_TIMEOUT);
     return TWDR;
 }
 //------------------------------------------------------------------------------
@@ -193,28 +812,37 @@ bool TwiMaster::restart(uint8_t addressRW) {
     \return The value true for success or false for failure.
 */
 bool TwiMaster::start(uint8_t addressRW) {
+    I2C_TRACE_BEGIN();
     // send START condition
     execCmd((1 << TWINT) | (1 << TWSTA) | (1 << TWEN));
     if (status() != TWSR_START && status() != TWSR_REP_START) {
+        I2C_TRACE_END(I2C_PHASE_START, false);
         return false;
     }
+    I2C_TRACE_MARK(I2C_PHASE_START, true);
 
     // send device address and direction
     TWDR = addressRW;
     execCmd((1 << TWINT) | (1 << TWEN));
-    if (addressRW & I2C_READ) {
-        return status() == TWSR_MRX_ADR_ACK;
-    } else {
-        return status() == TWSR_MTX_ADR_ACK;
-    }
+    bool ack = status() == ((addressRW & I2C_READ) ? TWSR_MRX_ADR_ACK : TWSR_MTX_ADR_ACK);
+    I2C_TRACE_END(I2C_PHASE_ADDRESS, ack);
+    return ack;
 }
 //------------------------------------------------------------------------------
 /** Issue a stop condition. */
 void TwiMaster::stop(void) {
+    I2C_TRACE_BEGIN();
     TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWSTO);
 
     // wait until stop condition is executed and bus released
-    while (TWCR & (1 << TWSTO));
+    uint32_t t0 = micros();
+    while (TWCR & (1 << TWSTO)) {
+        if (micros() - t0 > I2C_TIMEOUT_USEC) {
+            timeout();
+            break;
+        }
+    }
+    I2C_TRACE_END(I2C_PHASE_STOP, status() != TWSR_TIMEOUT);
 }
 //------------------------------------------------------------------------------
 /**
@@ -225,74 +853,655 @@ void TwiMaster::stop(void) {
     \return The value true, 1, if the slave returned an Ack or false for Nak.
 */
 bool TwiMaster::write(uint8_t data) {
+    I2C_TRACE_BEGIN();
     TWDR = data;
     execCmd((1 << TWINT) | (1 << TWEN));
+    I2C_TRACE_END(I2C_PHASE_DATA, status() == TWSR_MTX_DATA_ACK);
     return status() == TWSR_MTX_DATA_ACK;
 }
+//------------------------------------------------------------------------------
+/**
+    Hold SCL low or release it, with the bus idle. The TWI is disabled
+    while SCL is held, so the pin can be driven as a port pin; on release
+    the pin gets the internal pull-up back if the constructor enabled it.
 
-#elif defined(ARDUINO_ARCH_ESP8266) 
-#include <twi.h>
+    \param[in] low Set true to pull SCL low, false to give SCL back to the TWI.
+*/
+void TwiMaster::holdScl(bool low) {
+    if (low) {
+        TWCR = 0;
+        digitalWrite(TWI_SCL_PIN, LOW);
+        pinMode(TWI_SCL_PIN, OUTPUT);
+    } else {
+        pinMode(TWI_SCL_PIN, pullup_ ? INPUT_PULLUP : INPUT);
+        TWCR = (1 << TWEN);
+    }
+}
 //------------------------------------------------------------------------------
 /**
-    Initialize hardware TWI.
+    Clock SCL as a port pin, the TWI disabled, until the slave holding SDA
+    low releases it; then give the pins back to the TWI, with the pull-ups
+    the constructor chose, and issue a stop.
 
-    \param[in] enablePullup Enable the AVR internal pull-ups. The internal
-    pull-ups can, in some systems, eliminate the need for external pull-ups.
+    \return The value true if SDA is high again.
+*/
+bool TwiMaster::recover(void) {
+    uint8_t release = pullup_ ? INPUT_PULLUP : INPUT;
+    TWCR = 0;
+    pinMode(TWI_SDA_PIN, release);
+    for (uint8_t i = 0; i < I2C_RECOVER_CLOCKS && !digitalRead(TWI_SDA_PIN); i++) {
+        // open drain: output low, or input pulled high
+        digitalWrite(TWI_SCL_PIN, LOW);
+        pinMode(TWI_SCL_PIN, OUTPUT);
+        delayMicroseconds(5);
+        pinMode(TWI_SCL_PIN, release);
+        delayMicroseconds(5);
+    }
+    pinMode(TWI_SCL_PIN, release);
+    bool released = digitalRead(TWI_SDA_PIN);
+    TWCR = (1 << TWEN);
+    stop();
+    return released;
+}
+//------------------------------------------------------------------------------
+/**
+    Start an operation on the TWI hardware and return at once.
+
+    \param[in] op One of I2C_OP_START ... I2C_OP_STOP.
+
+    \param[in] data Address with read/write bit, byte to write or last flag.
+*/
+void TwiMaster::post(uint8_t op, uint8_t data) {
+    op_ = op;
+    posted_ = micros();
+    switch (op) {
+        case I2C_OP_START:
+        case I2C_OP_RESTART:
+            addressRW_ = data;
+            TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
+            break;
+        case I2C_OP_WRITE:
+            TWDR = data;
+            TWCR = (1 << TWINT) | (1 << TWEN);
+            break;
+        case I2C_OP_READ:
+            TWCR = (1 << TWINT) | (1 << TWEN) | (data ? 0 : (1 << TWEA));
+            break;
+        default:
+            op_ = I2C_OP_STOP;
+            TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWSTO);
+            break;
+    }
+}
+//------------------------------------------------------------------------------
+/**
+    Check the TWI hardware for completion of the posted operation. A start
+    takes two steps (condition, then address), chained from here.
+
+    \return The value true once result() is valid.
+*/
+bool TwiMaster::ready(void) {
+    if (op_ == TWI_OP_DONE) {
+        return true;
+    }
+    if (op_ == I2C_OP_STOP) {
+        if (TWCR & (1 << TWSTO)) {
+            if (micros() - posted_ > I2C_TIMEOUT_USEC) {
+                timeout();
+                result_ = false;
+                op_ = TWI_OP_DONE;
+                return true;
+            }
+            return false;
+        }
+        result_ = true;
+        op_ = TWI_OP_DONE;
+        return true;
+    }
+    if (!(TWCR & (1 << TWINT))) {
+        if (micros() - posted_ > I2C_TIMEOUT_USEC) {
+            timeout();
+            result_ = false;
+            op_ = TWI_OP_DONE;
+            return true;
+        }
+        return false;
+    }
+    status_ = TWSR & 0xF8;
+    switch (op_) {
+        case I2C_OP_START:
+        case I2C_OP_RESTART:
+            if (status_ != TWSR_START && status_ != TWSR_REP_START) {
+                result_ = false;
+                break;
+            }
+            // send device address and direction
+            TWDR = addressRW_;
+            TWCR = (1 << TWINT) | (1 << TWEN);
+            op_ = TWI_OP_ADDRESS;
+            return false;
+        case TWI_OP_ADDRESS:
+            if (addressRW_ & I2C_READ) {
+                result_ = status_ == TWSR_MRX_ADR_ACK;
+            } else {
+                result_ = status_ == TWSR_MTX_ADR_ACK;
+            }
+            break;
+        case I2C_OP_WRITE:
+            result_ = status_ == TWSR_MTX_DATA_ACK;
+            break;
+        default:
+            result_ = TWDR;
+            break;
+    }
+    op_ = TWI_OP_DONE;
+    return true;
+}
+
+#else  // ARDUINO_ARCH_AVR
+//------------------------------------------------------------------------------
+/**
+    Use the default Wire bus. It is begun on first use, not here, as the
+    bus can't be started from a global constructor on every core.
+
+    \param[in] enablePullup Unused, pull-ups are set by the Wire library.
 */
 TwiMaster::TwiMaster(bool /* enablePullup */) {
+    wire_ = &Wire;
+    sclHz_ = F_TWI;
+    begun_ = false;
+    writing_ = false;
+    held_ = false;
+    status_ = 0;
+    addressRW_ = 0;
+}
+//------------------------------------------------------------------------------
+/**
+    Use a given Wire bus.
 
+    \param[in] wire The bus (Wire, Wire1...).
+
+    \param[in] sclHz SCL frequency in Hz.
+*/
+TwiMaster::TwiMaster(TwoWire& wire, uint32_t sclHz) {
+    wire_ = &wire;
+    sclHz_ = sclHz;
+    begun_ = false;
+    writing_ = false;
+    held_ = false;
+    status_ = 0;
+    addressRW_ = 0;
 }
 //------------------------------------------------------------------------------
-/** Read a byte and send Ack if more reads follow else Nak to terminate read.
+/** Begin the Wire bus, once. */
+void TwiMaster::begin(void) {
+    if (!begun_) {
+        wire_->begin();
+        wire_->setClock(sclHz_);
+        begun_ = true;
+    }
+}
+//------------------------------------------------------------------------------
+/** End the Wire bus, so its pins can be driven as GPIOs. */
+void TwiMaster::end(void) {
+    #if !defined(ARDUINO_ARCH_ESP8266)
+    // ESP8266 Wire is a software TWI on plain GPIOs, without end()
+    wire_->end();
+    #endif  // ARDUINO_ARCH_ESP8266
+    begun_ = false;
+}
+//------------------------------------------------------------------------------
+/**
+    Set the SCL frequency.
+
+    \param[in] sclHz SCL frequency in Hz.
+*/
+void TwiMaster::setClock(uint32_t sclHz) {
+    sclHz_ = sclHz;
+    if (begun_) {
+        wire_->setClock(sclHz_);
+    }
+}
+//------------------------------------------------------------------------------
+/**
+    Write then read as one transaction: one Wire message for the bytes to
+    write, kept open with a repeated start, then one for the bytes to read.
+
+    \return The value true if the slave acked, else false with the bus
+    stopped.
+*/
+bool TwiMaster::transfer(uint8_t address, const uint8_t* tx, uint8_t txLen,
+                         uint8_t* rx, uint8_t rxLen, bool /* first */, bool last) {
+    // Wire chooses start or repeated start from how the last message ended
+    begin();
+    addressRW_ = address << 1;
+    if (txLen || !rxLen) {
+        wire_->beginTransmission(address);
+        if (txLen) {
+            wire_->write(tx, txLen);
+        }
+        status_ = wire_->endTransmission((uint8_t)(rxLen ? false : last));
+        held_ = !status_ && (rxLen || !last);
+        if (status_) {
+            return false;
+        }
+    }
+    if (rxLen) {
+        if (wire_->requestFrom(address, rxLen, (uint8_t)last) != rxLen) {
+            held_ = false;
+            return false;
+        }
+        held_ = !last;
+        while (rxLen--) {
+            *rx++ = wire_->read();
+        }
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+/**
+    Run a whole transfer for I2cAsync, as transfer(): Wire blocks until
+    each message is done, so the transfer is complete on return.
+
+    \return The value true, the transfer is always started.
+*/
+bool TwiMaster::postTransfer(uint8_t address, const uint8_t* tx, uint8_t txLen,
+                             uint8_t* rx, uint8_t rxLen) {
+    result_ = transfer(address, tx, txLen, rx, rxLen, true, true);
+    return true;
+}
+//------------------------------------------------------------------------------
+/** Read a byte, as a message of its own.
 
     \param[in] last Set true to terminate the read else false.
 
     \return The byte read from the I2C bus.
 */
 uint8_t TwiMaster::read(uint8_t last) {
-    uint8_t rxBuffer;
-    twi_readFrom(addressRW_, &rxBuffer, 1, last);
-    return rxBuffer;
+    if (!wire_->available()) {
+        wire_->requestFrom((uint8_t)(addressRW_ >> 1), (uint8_t)1, (uint8_t)last);
+        held_ = !last;
+    }
+    return wire_->read();
 }
 //------------------------------------------------------------------------------
-/** Issue a restart condition.
+/** Issue a restart condition: send the buffered bytes, keeping the bus.
 
     \param[in] addressRW I2C address with read/write bit.
 
     \return The value true, 1, for success or false, 0, for failure.
 */
 bool TwiMaster::restart(uint8_t addressRW) {
+    if (writing_) {
+        writing_ = false;
+        status_ = wire_->endTransmission((uint8_t)false);
+        held_ = !status_;
+        if (status_) {
+            return false;
+        }
+    }
     return start(addressRW);
 }
 //------------------------------------------------------------------------------
-/** Issue a start condition.
+/** Issue a start condition. A write is buffered until the next restart or
+    stop; a read is sent by read().
 
     \param[in] addressRW I2C address with read/write bit.
 
-    \return The value true for success or false for failure.
+    \return The value true (the Ack is only known when the message is sent).
 */
 bool TwiMaster::start(uint8_t addressRW) {
+    begin();
     addressRW_ = addressRW;
-    twi_init(TWI_SDA_PIN, TWI_SCL_PIN);
-    // TODO: set frequency/conversion etc.
+    if (!(addressRW & I2C_READ)) {
+        wire_->beginTransmission((uint8_t)(addressRW >> 1));
+        writing_ = true;
+    }
+    return true;
 }
 //------------------------------------------------------------------------------
-/** Issue a stop condition. */
+/** Issue a stop condition, sending the buffered bytes if any. Wire has
+    no bare stop: after a message that kept the bus, an empty message to
+    the same slave ends with the stop. */
 void TwiMaster::stop(void) {
-    twi_stop();
+    if (writing_) {
+        writing_ = false;
+        status_ = wire_->endTransmission();
+    } else if (held_) {
+        wire_->beginTransmission((uint8_t)(addressRW_ >> 1));
+        status_ = wire_->endTransmission();
+    }
+    held_ = false;
 }
 //------------------------------------------------------------------------------
 /**
     Write a byte.
 
-    \param[in] data The byte to send.
+    \param[in] data The byte to buffer.
 
-    \return The value true, 1, if the slave returned an Ack or false for Nak.
+    \return The value true, 1, if the byte fits in the Wire buffer.
 */
 bool TwiMaster::write(uint8_t data) {
-    twi_writeTo(addressRW_, &data, 1, true);
+    return writing_ && wire_->write(data) == 1;
+}
+//------------------------------------------------------------------------------
+/**
+    Hold SCL low or release it, with the bus idle. Wire is ended first, as
+    the peripheral keeps the pin while it is begun, and begun again when
+    SCL is released.
+
+    \param[in] low Set true to pull SCL low, false to give SCL back to Wire.
+*/
+void TwiMaster::holdScl(bool low) {
+    #if defined(PIN_WIRE_SCL)
+    if (low) {
+        end();
+        digitalWrite(PIN_WIRE_SCL, LOW);
+        pinMode(PIN_WIRE_SCL, OUTPUT);
+    } else {
+        pinMode(PIN_WIRE_SCL, INPUT);
+        begun_ = false;
+        begin();
+    }
+    #else  // PIN_WIRE_SCL
+    (void)low;
+    #endif  // PIN_WIRE_SCL
+}
+//------------------------------------------------------------------------------
+/**
+    Clock SCL as a GPIO until the slave holding SDA low releases it, then
+    begin Wire again. Wire is ended first, as the peripheral keeps the pins
+    while it is begun. Without PIN_WIRE_SCL/PIN_WIRE_SDA in the core, only
+    Wire is begun again.
+
+    \return The value true if SDA is high again, or its state is unknown.
+*/
+bool TwiMaster::recover(void) {
+    bool released = true;
+    #if defined(PIN_WIRE_SCL) && defined(PIN_WIRE_SDA)
+    end();
+    pinMode(PIN_WIRE_SDA, INPUT_PULLUP);
+    pinMode(PIN_WIRE_SCL, INPUT_PULLUP);
+    for (uint8_t i = 0; i < I2C_RECOVER_CLOCKS && !digitalRead(PIN_WIRE_SDA); i++) {
+        // open drain: output low, or input pulled high
+        digitalWrite(PIN_WIRE_SCL, LOW);
+        pinMode(PIN_WIRE_SCL, OUTPUT);
+        delayMicroseconds(5);
+        pinMode(PIN_WIRE_SCL, INPUT_PULLUP);
+        delayMicroseconds(5);
+    }
+    released = digitalRead(PIN_WIRE_SDA);
+    #endif  // PIN_WIRE_SCL && PIN_WIRE_SDA
+    begun_ = false;
+    begin();
+    return released;
+}
+#endif  // ARDUINO_ARCH_AVR
+//==============================================================================
+// I2cAsync states
+uint8_t const ASYNC_IDLE = 0;
+uint8_t const ASYNC_ADDRESS_WRITE = 1;
+uint8_t const ASYNC_WRITE = 2;
+uint8_t const ASYNC_ADDRESS_READ = 3;
+uint8_t const ASYNC_READ = 4;
+uint8_t const ASYNC_STOP = 5;
+uint8_t const ASYNC_TRANSFER = 6;
+//------------------------------------------------------------------------------
+/**
+    Create an engine driving the given bus.
+
+    \param[in] bus Any I2C master. While transfers are queued, the bus must
+    not be used directly.
+*/
+I2cAsync::I2cAsync(I2cMasterBase* bus) {
+    bus_ = bus;
+    head_ = 0;
+    tail_ = 0;
+    state_ = ASYNC_IDLE;
+    index_ = 0;
+    status_ = I2C_DONE;
+}
+//------------------------------------------------------------------------------
+/**
+    Queue a transfer. Returns at once; completion is reported through
+    transfer->status and transfer->callback.
+
+    \param[in] transfer The transfer, owned by the caller.
+
+    \return The value true if queued, false if already pending.
+*/
+bool I2cAsync::submit(I2cTransfer* transfer) {
+    if (transfer->status == I2C_PENDING) {
+        return false;
+    }
+    transfer->status = I2C_PENDING;
+    transfer->next = 0;
+    noInterrupts();
+    if (tail_) {
+        tail_->next = transfer;
+    } else {
+        head_ = transfer;
+    }
+    tail_ = transfer;
+    interrupts();
+    return true;
 }
+//------------------------------------------------------------------------------
+/** Dequeue the current transfer and report its status. */
+void I2cAsync::complete(int8_t status) {
+    I2cTransfer* transfer = head_;
+    noInterrupts();
+    head_ = transfer->next;
+    if (!head_) {
+        tail_ = 0;
+    }
+    interrupts();
+    state_ = ASYNC_IDLE;
+    transfer->status = status;
+    if (transfer->callback) {
+        transfer->callback(transfer);
+    }
+}
+//------------------------------------------------------------------------------
+/**
+    Advance the current transfer by at most one bus operation. Returns
+    immediately if the bus is still busy with the previous one.
+
+    \return The value true while transfers remain queued.
+*/
+bool I2cAsync::poll(void) {
+    I2cTransfer* t = head_;
+    if (!t) {
+        return false;
+    }
+    if (state_ != ASYNC_IDLE && !bus_->ready()) {
+        return true;
+    }
+    uint8_t result = state_ == ASYNC_IDLE ? 0 : bus_->result();
+    switch (state_) {
+        case ASYNC_IDLE:
+            index_ = 0;
+            status_ = I2C_DONE;
+            if (bus_->postTransfer(t->address, t->tx, t->txLen, t->rx, t->rxLen)) {
+                state_ = ASYNC_TRANSFER;
+            } else if (t->txLen || !t->rxLen) {
+                state_ = ASYNC_ADDRESS_WRITE;
+                bus_->post(I2C_OP_START, t->address << 1 | I2C_WRITE);
+            } else {
+                state_ = ASYNC_ADDRESS_READ;
+                bus_->post(I2C_OP_START, t->address << 1 | I2C_READ);
+            }
+            break;
+        case ASYNC_ADDRESS_WRITE:
+        case ASYNC_WRITE:
+            if (!result) {
+                status_ = I2C_NAK;
+                state_ = ASYNC_STOP;
+                bus_->post(I2C_OP_STOP, 0);
+            } else if (index_ < t->txLen) {
+                state_ = ASYNC_WRITE;
+                bus_->post(I2C_OP_WRITE, t->tx[index_++]);
+            } else if (t->rxLen) {
+                state_ = ASYNC_ADDRESS_READ;
+                bus_->post(I2C_OP_RESTART, t->address << 1 | I2C_READ);
+            } else {
+                state_ = ASYNC_STOP;
+                bus_->post(I2C_OP_STOP, 0);
+            }
+            break;
+        case ASYNC_ADDRESS_READ:
+            if (!result) {
+                status_ = I2C_NAK;
+                state_ = ASYNC_STOP;
+                bus_->post(I2C_OP_STOP, 0);
+            } else {
+                index_ = 0;
+                state_ = ASYNC_READ;
+                bus_->post(I2C_OP_READ, t->rxLen == 1);
+            }
+            break;
+        case ASYNC_READ:
+            t->rx[index_++] = result;
+            if (index_ < t->rxLen) {
+                bus_->post(I2C_OP_READ, index_ == t->rxLen - 1);
+            } else {
+                state_ = ASYNC_STOP;
+                bus_->post(I2C_OP_STOP, 0);
+            }
+            break;
+        case ASYNC_TRANSFER:
+            complete(result ? I2C_DONE : I2C_NAK);
+            break;
+        default:
+            complete(status_);
+            break;
+    }
+    return head_ != 0;
+}
+//==============================================================================
+#if defined(I2C_INSTRUMENT)
+
+I2cInstrument i2cInstrument;
+
+static uint32_t instrumentMicros(void) {
+    return micros();
+}
+//------------------------------------------------------------------------------
+/** Clear all counters; utilization over a 1 s window by default. */
+I2cInstrument::I2cInstrument() {
+    clock_ = instrumentMicros;
+    window_ = 1000000UL;
+    reset();
+}
+//------------------------------------------------------------------------------
+/** Clear the histograms, Nak counts and utilization. */
+void I2cInstrument::reset(void) {
+    for (uint8_t p = 0; p < I2C_PHASES; p++) {
+        for (uint8_t b = 0; b < I2C_HIST_BUCKETS; b++) {
+            hist_[p][b] = 0;
+        }
+        naks_[p] = 0;
+        total_[p] = 0;
+    }
+    busy_ = 0;
+    utilization_ = 0;
+    next_ = I2C_PHASES;
+    windowStart_ = clock_();
+}
+//------------------------------------------------------------------------------
+/**
+    Record one phase.
 
-#else
-// #error unknown CPU
-#endif
+    \param[in] phase One of I2C_PHASE_START ... I2C_PHASE_WRITE.
+
+    \param[in] start Time the phase began.
+
+    \param[in] ack False to count a Nak (or a failed call).
+
+    \return The time the phase ended, start of the next one.
+*/
+uint32_t I2cInstrument::record(uint8_t phase, uint32_t start, bool ack) {
+    uint32_t end = clock_();
+    uint32_t us = end - start;
+    if (next_ < I2C_PHASES) {
+        phase = next_;
+        next_ = I2C_PHASES;
+    }
+    uint8_t bucket = 0;
+    while (bucket < I2C_HIST_BUCKETS - 1 && (us >> bucket)) {
+        bucket++;
+    }
+    if (hist_[phase][bucket] != 0XFFFF) {
+        hist_[phase][bucket]++;
+    }
+    if (!ack) {
+        naks_[phase]++;
+    }
+    total_[phase] += us;
+    // device phases overlap the bus phases they are made of
+    if (phase <= I2C_PHASE_STOP) {
+        busy_ += us;
+        roll(end);
+    }
+    return end;
+}
+//------------------------------------------------------------------------------
+/** Close the utilization window once it is over. */
+void I2cInstrument::roll(uint32_t now) {
+    uint32_t elapsed = now - windowStart_;
+    if (elapsed < window_) {
+        return;
+    }
+    uint32_t percent = (uint64_t)busy_ * 100 / elapsed;
+    utilization_ = percent > 100 ? 100 : percent;
+    busy_ = 0;
+    windowStart_ = now;
+}
+//------------------------------------------------------------------------------
+/** \return Percentage of the last complete window the bus was busy. */
+uint8_t I2cInstrument::utilization(void) {
+    roll(clock_());
+    return utilization_;
+}
+//------------------------------------------------------------------------------
+/**
+    Print the histograms as CSV: one line per phase with calls, Naks,
+    total microseconds and the bucket counts, then the utilization.
+
+    \param[in] out Where to print (Serial, a network client...).
+*/
+void I2cInstrument::dump(Print& out) {
+    static const char* const names[I2C_PHASES] = {
+        "start", "address", "data", "stop", "read", "write"
+    };
+    out.print("phase,calls,naks,us");
+    out.print(",0");
+    for (uint8_t b = 1; b < I2C_HIST_BUCKETS - 1; b++) {
+        out.print(",<");
+        out.print(1UL << b);
+    }
+    out.print(",>=");
+    out.print(1UL << (I2C_HIST_BUCKETS - 2));
+    out.println();
+    for (uint8_t p = 0; p < I2C_PHASES; p++) {
+        uint32_t calls = 0;
+        for (uint8_t b = 0; b < I2C_HIST_BUCKETS; b++) {
+            calls += hist_[p][b];
+        }
+        out.print(names[p]);
+        out.print(',');
+        out.print(calls);
+        out.print(',');
+        out.print(naks_[p]);
+        out.print(',');
+        out.print(total_[p]);
+        for (uint8_t b = 0; b < I2C_HIST_BUCKETS; b++) {
+            out.print(',');
+            out.print(hist_[p][b]);
+        }
+        out.println();
+    }
+    out.print("utilization,");
+    out.println(utilization());
+}
+#endif  // I2C_INSTRUMENT
@@ -28,12 +28,24 @@
 #else  // ARDUINO
     #include <Arduino.h>
 #endif  // ARDUINO
+#if !defined(ARDUINO_ARCH_AVR)
+    #include <Wire.h>
+#endif  // ARDUINO_ARCH_AVR
 /** hardware I2C clock in Hz */
 uint32_t const F_TWI = 400000L;
 
 /** Delay used for software I2C */
 uint8_t const I2C_DELAY_USEC = 4;
 
+/** default clock in Hz for FastSoftI2cMaster */
+uint32_t const F_SOFT_I2C = 100000L;
+
+/** longest wait for the TWI hardware, the SMBus clock low timeout */
+uint32_t const I2C_TIMEOUT_USEC = 25000L;
+
+/** most SCL pulses sent by recover() to free SDA */
+uint8_t const I2C_RECOVER_CLOCKS = 9;
+
 /** Bit to or with address for read start and read restart */
 uint8_t const I2C_READ = 1;
 
@@ -57,6 +69,129 @@ uint8_t const TWSR_MTX_DATA_ACK = 0x28;
 /** slave address plus read bit transmitted, ACK received */
 uint8_t const TWSR_MRX_ADR_ACK = 0x40;
 
+/** no TWI state: the command timed out and the TWI was reset */
+uint8_t const TWSR_TIMEOUT = 0xF8;
+//------------------------------------------------------------------------------
+// Operations for I2cMasterBase::post()
+
+/** start condition plus address, data is address with read/write bit */
+uint8_t const I2C_OP_START = 0;
+
+/** repeated start plus address, data is address with read/write bit */
+uint8_t const I2C_OP_RESTART = 1;
+
+/** write a byte, data is the byte */
+uint8_t const I2C_OP_WRITE = 2;
+
+/** read a byte, data is true for the last byte (Nak) */
+uint8_t const I2C_OP_READ = 3;
+
+/** stop condition */
+uint8_t const I2C_OP_STOP = 4;
+//------------------------------------------------------------------------------
+// Phases timed by I2cInstrument
+
+/** start or restart condition */
+uint8_t const I2C_PHASE_START = 0;
+
+/** address byte with read/write bit, and its Ack */
+uint8_t const I2C_PHASE_ADDRESS = 1;
+
+/** one data byte written or read, and its Ack */
+uint8_t const I2C_PHASE_DATA = 2;
+
+/** stop condition */
+uint8_t const I2C_PHASE_STOP = 3;
+
+/** a whole device register read (e.g. MLX90615 readReg/readAll) */
+uint8_t const I2C_PHASE_READ = 4;
+
+/** a whole device register write (e.g. MLX90615 writeReg) */
+uint8_t const I2C_PHASE_WRITE = 5;
+
+/** number of phases */
+uint8_t const I2C_PHASES = 6;
+
+/** histogram buckets: 0 us, 1 us, 2..3 us, ... 2^13..2^14-1 us, more */
+uint8_t const I2C_HIST_BUCKETS = 16;
+
+#if defined(I2C_INSTRUMENT)
+/**
+    \class I2cInstrument
+    \brief Bus timing histograms, Nak counts and bus utilization
+
+    Compiled in with the I2C_INSTRUMENT build flag (it must reach
+    I2cMaster.cpp, so a -D option rather than a #define in the sketch).
+    The bus primitives and the device drivers then record each phase in
+    the single instance i2cInstrument. Without the flag the I2C_TRACE_*
+    hooks expand to nothing and no instance exists.
+*/
+class I2cInstrument {
+  public:
+    I2cInstrument();
+    /** Replace micros() as time base (e.g. a simulated bus clock) */
+    void setClock(uint32_t (*us)(void)) {
+        clock_ = us;
+    }
+    /** Set the rolling window of utilization(), in microseconds */
+    void setWindow(uint32_t us) {
+        window_ = us;
+    }
+    /** \return current time of the clock */
+    uint32_t now(void) {
+        return clock_();
+    }
+    /** Have the next phase recorded as another one (e.g. a byte write
+        that sends the address) */
+    void next(uint8_t phase) {
+        next_ = phase;
+    }
+    uint32_t record(uint8_t phase, uint32_t start, bool ack);
+    void reset(void);
+    /** \return calls of a phase in one histogram bucket */
+    uint16_t count(uint8_t phase, uint8_t bucket) {
+        return hist_[phase][bucket];
+    }
+    /** \return Naks of a bus phase, failed calls of READ/WRITE */
+    uint32_t naks(uint8_t phase) {
+        return naks_[phase];
+    }
+    /** \return total time spent in a phase, in microseconds */
+    uint32_t total(uint8_t phase) {
+        return total_[phase];
+    }
+    uint8_t utilization(void);
+    void dump(Print& out);
+  private:
+    void roll(uint32_t now);
+    uint16_t hist_[I2C_PHASES][I2C_HIST_BUCKETS];
+    uint32_t naks_[I2C_PHASES];
+    uint32_t total_[I2C_PHASES];
+    uint32_t busy_;
+    uint32_t windowStart_;
+    uint32_t window_;
+    uint8_t utilization_;
+    uint8_t next_;
+    uint32_t (*clock_)(void);
+};
+
+extern I2cInstrument i2cInstrument;
+
+/** start timing, in the scope of the hooks below */
+#define I2C_TRACE_BEGIN()           uint32_t i2cTrace_ = i2cInstrument.now()
+/** record a phase and time the next one from here */
+#define I2C_TRACE_MARK(phase, ack)  i2cTrace_ = i2cInstrument.record(phase, i2cTrace_, ack)
+/** record the last phase */
+#define I2C_TRACE_END(phase, ack)   i2cInstrument.record(phase, i2cTrace_, ack)
+/** record the next phase as another one */
+#define I2C_TRACE_NEXT(phase)       i2cInstrument.next(phase)
+#else  // I2C_INSTRUMENT
+#define I2C_TRACE_BEGIN()
+#define I2C_TRACE_MARK(phase, ack)
+#define I2C_TRACE_END(phase, ack)
+#define I2C_TRACE_NEXT(phase)
+#endif  // I2C_INSTRUMENT
+
 //------------------------------------------------------------------------------
 /**
     \class I2cMasterBase
@@ -85,6 +220,66 @@ class I2cMasterBase {
         \param[in] data byte to write
         \return true for Ack or false for Nak */
     virtual bool write(uint8_t data) = 0;
+    /** Begin an operation without waiting for it to complete.
+        The default runs the blocking primitive, so any bus can be driven
+        by I2cAsync; TwiMaster on AVR overrides it to return at once.
+        \param[in] op one of I2C_OP_START ... I2C_OP_STOP
+        \param[in] data address, byte to write or last flag (see I2C_OP_*)
+    */
+    virtual void post(uint8_t op, uint8_t data);
+    /** Begin a whole write then read transfer (start, txLen bytes,
+        repeated start, rxLen bytes, stop) without waiting for it, on buses
+        that only move whole messages. I2cAsync tries it first and falls
+        back to post() per byte when it returns false, as this default does.
+        \return true if the transfer was started; ready() then tells when
+        it is complete, with result() true if the slave acked
+    */
+    virtual bool postTransfer(uint8_t address, const uint8_t* tx, uint8_t txLen,
+                              uint8_t* rx, uint8_t rxLen) {
+        (void)address;
+        (void)tx;
+        (void)txLen;
+        (void)rx;
+        (void)rxLen;
+        return false;
+    }
+    /** \return true once the operation started by post() is complete */
+    virtual bool ready(void) {
+        return true;
+    }
+    /** \return Ack (true/false) or byte read of the completed operation */
+    virtual uint8_t result(void) {
+        return result_;
+    }
+    /** Hold SCL low outside of any transaction, or release it (e.g. the
+        SCL low pulse that wakes a MLX90615 from sleep). The default, for
+        buses without control of the pin, does nothing.
+        \param[in] low true to pull SCL low, false to release it
+    */
+    virtual void holdScl(bool low) {
+        (void)low;
+    }
+    /** Free a bus held by a slave (SDA stuck low, e.g. after a reset in
+        the middle of a read): clock SCL until the slave releases SDA, at
+        most I2C_RECOVER_CLOCKS times, then issue a stop. The default, for
+        buses without control of the pins, only issues the stop.
+        \return true if SDA is released
+    */
+    virtual bool recover(void) {
+        stop();
+        return true;
+    }
+    /** Write then read as one transaction: start (or repeated start if
+        first is false), txLen bytes, repeated start, rxLen bytes, stop if
+        last. The default runs the byte primitives; buses that move whole
+        messages override it with bursts.
+        \param[in] address 7-bit address
+        \return true if the slave acked, else false with the bus stopped
+    */
+    virtual bool transfer(uint8_t address, const uint8_t* tx, uint8_t txLen,
+                          uint8_t* rx, uint8_t rxLen, bool first, bool last);
+  protected:
+    uint8_t result_;
 };
 //------------------------------------------------------------------------------
 /**
@@ -99,44 +294,245 @@ class SoftI2cMaster : public I2cMasterBase {
     bool start(uint8_t addressRW);
     void stop(void);
     bool write(uint8_t b);
+    void holdScl(bool low);
+    bool recover(void);
   private:
     SoftI2cMaster() {}
     uint8_t sdaPin_;
     uint8_t sclPin_;
 };
 //------------------------------------------------------------------------------
+/**
+    \class FastSoftI2cMaster
+    \brief Software I2C master with direct port access
+
+    Same bus sequences as SoftI2cMaster, but on AVR the pins are resolved
+    to port registers and bit masks once, in the constructor, instead of
+    going through digitalWrite/digitalRead for every bit. The clock is set
+    in Hz rather than fixed by I2C_DELAY_USEC. Other architectures keep
+    the pin functions, with the same clock setting.
+*/
+class FastSoftI2cMaster : public I2cMasterBase {
+  public:
+    FastSoftI2cMaster(uint8_t sdaPin, uint8_t sclPin, uint32_t sclHz = F_SOFT_I2C);
+    void setClock(uint32_t sclHz);
+    uint8_t read(uint8_t last);
+    bool restart(uint8_t addressRW);
+    bool start(uint8_t addressRW);
+    void stop(void);
+    bool write(uint8_t b);
+    void holdScl(bool low);
+    bool recover(void);
+  private:
+    FastSoftI2cMaster() {}
+    void sclWrite(uint8_t level);
+    void sdaWrite(uint8_t level);
+    void sdaMode(uint8_t mode);
+    uint8_t sdaRead(void);
+    void halfBit(void) {
+        delayMicroseconds(halfBitUsec_);
+    }
+    uint8_t halfBitUsec_;
+    #if defined(ARDUINO_ARCH_AVR)
+    volatile uint8_t* sdaOut_;
+    volatile uint8_t* sdaIn_;
+    volatile uint8_t* sdaDdr_;
+    volatile uint8_t* sclOut_;
+    uint8_t sdaMask_;
+    uint8_t sclMask_;
+    #else
+    uint8_t sdaPin_;
+    uint8_t sclPin_;
+    #endif
+};
+//------------------------------------------------------------------------------
+/** maximum number of SDA lines clocked together by SoftI2cMultiMaster */
+uint8_t const I2C_MULTI_MAX_BUSES = 8;
+
+/**
+    \class SoftI2cMultiMaster
+    \brief Software I2C master driving several buses in lockstep
+
+    Up to I2C_MULTI_MAX_BUSES SDA lines share one SCL line, and every bus
+    sees the same bytes written (e.g. one device per bus, all at the same
+    address). Each SCL pulse then moves one bit on all buses at once: Acks
+    come back as a mask with bit i for bus i, and reads fill one byte per
+    bus. On AVR, when all SDA pins are on the same port, all lines are
+    driven with one register write and sampled with one register read.
+*/
+class SoftI2cMultiMaster {
+  public:
+    SoftI2cMultiMaster(const uint8_t* sdaPins, uint8_t count, uint8_t sclPin,
+                       uint32_t sclHz = F_SOFT_I2C);
+    void setClock(uint32_t sclHz);
+    /** \return number of buses */
+    uint8_t count(void) {
+        return count_;
+    }
+    /** \return mask with the bit of every bus set */
+    uint8_t all(void) {
+        return (uint8_t)((1 << count_) - 1);
+    }
+    void read(uint8_t last, uint8_t* data);
+    uint8_t restart(uint8_t addressRW);
+    uint8_t start(uint8_t addressRW);
+    void stop(void);
+    uint8_t write(uint8_t data);
+  private:
+    SoftI2cMultiMaster() {}
+    void sclWrite(uint8_t level);
+    void sdaWrite(uint8_t level);
+    void sdaMode(uint8_t mode);
+    uint8_t sdaRead(void);
+    void halfBit(void) {
+        delayMicroseconds(halfBitUsec_);
+    }
+    uint8_t halfBitUsec_;
+    uint8_t count_;
+    uint8_t sclPin_;
+    uint8_t sdaPins_[I2C_MULTI_MAX_BUSES];
+    #if defined(ARDUINO_ARCH_AVR)
+    bool samePort_;
+    volatile uint8_t* sdaOut_;
+    volatile uint8_t* sdaIn_;
+    volatile uint8_t* sdaDdr_;
+    volatile uint8_t* sclOut_;
+    uint8_t sdaMask_;
+    uint8_t sclMask_;
+    uint8_t laneMask_[I2C_MULTI_MAX_BUSES];
+    #endif
+};
+//------------------------------------------------------------------------------
 /**
     \class TwiMaster
     \brief Hardware I2C master class
 
-    Uses ATmega TWI hardware port
+    Uses the ATmega TWI hardware port on AVR. Other architectures (ESP8266,
+    ESP32, RP2040, nRF52, SAMD...) go through their Wire library, begun once
+    on first use. Wire only moves whole messages, so transfer() is the
+    efficient path there: one write burst, a repeated start and one read
+    burst. I2cAsync gets the same bursts through postTransfer(). The byte
+    primitives are kept for compatibility: writes are buffered until the
+    next restart or stop (their Ack is only known then), and each read is
+    a message of its own, so only single byte reads are exact.
+
+    On AVR, a wait for the hardware longer than I2C_TIMEOUT_USEC (a slave
+    holding SCL or SDA low) resets the TWI and fails the operation, with
+    status() TWSR_TIMEOUT; recover() can then clock the slave free.
 */
 class TwiMaster : public I2cMasterBase {
   public:
     explicit TwiMaster(bool enablePullup);
+    void setClock(uint32_t sclHz);
     uint8_t read(uint8_t last);
     bool restart(uint8_t addressRW);
     bool start(uint8_t addressRW);
-    /** \return status from last TWI command - useful for library debug */
-    #if defined(ARDUINO_ARCH_AVR)
+    /** \return status from last TWI command (Wire: endTransmission()
+        result) - useful for library debug */
     uint8_t status(void) {
         return status_;
     }
-    #endif
     void stop(void);
     bool write(uint8_t data);
+    void holdScl(bool low);
+    bool recover(void);
   private:
     TwiMaster() {}
+    uint8_t status_;
+    uint8_t addressRW_;
 
     #if defined(ARDUINO_ARCH_AVR)
 
-    uint8_t status_;
+    uint8_t op_;
+    uint32_t posted_;
+    bool pullup_;
     void execCmd(uint8_t cmdReg);
+    void timeout(void);
 
-    #elif defined(ARDUINO_ARCH_ESP8266) 
-    uint8_t addressRW_ = 0;
-    #else
-// #error unknown CPU
-    #endif
+  public:
+    void post(uint8_t op, uint8_t data);
+    bool ready(void);
+
+    #else  // ARDUINO_ARCH_AVR
+
+  public:
+    explicit TwiMaster(TwoWire& wire, uint32_t sclHz = F_TWI);
+    bool transfer(uint8_t address, const uint8_t* tx, uint8_t txLen,
+                  uint8_t* rx, uint8_t rxLen, bool first, bool last);
+    bool postTransfer(uint8_t address, const uint8_t* tx, uint8_t txLen,
+                      uint8_t* rx, uint8_t rxLen);
+  private:
+    void begin(void);
+    void end(void);
+    TwoWire* wire_;
+    uint32_t sclHz_;
+    bool begun_;
+    bool writing_;
+    bool held_;
+    #endif  // ARDUINO_ARCH_AVR
+};
+//------------------------------------------------------------------------------
+/** I2cTransfer::status while queued or in progress */
+int8_t const I2C_PENDING = 1;
+
+/** I2cTransfer::status on success */
+int8_t const I2C_DONE = 0;
+
+/** I2cTransfer::status when the slave did not Ack */
+int8_t const I2C_NAK = -2;
+
+/**
+    \class I2cTransfer
+    \brief Write then read transaction for I2cAsync
+
+    Owned by the caller and linked into the queue, so submitting never
+    allocates. Must stay valid until status is no longer I2C_PENDING.
+*/
+struct I2cTransfer {
+    /** 7-bit slave address */
+    uint8_t address;
+    /** bytes to write, then a repeated start if rxLen is not zero */
+    const uint8_t* tx;
+    uint8_t txLen;
+    /** buffer for the bytes to read */
+    uint8_t* rx;
+    uint8_t rxLen;
+    /** I2C_PENDING, I2C_DONE or I2C_NAK */
+    volatile int8_t status;
+    /** called from I2cAsync::poll() on completion, may be null */
+    void (*callback)(I2cTransfer* transfer);
+    /** free for the owner of the transfer */
+    void* context;
+    I2cTransfer* next;
+};
+//------------------------------------------------------------------------------
+/**
+    \class I2cAsync
+    \brief Non-blocking transaction engine on top of any I2cMasterBase
+
+    Transfers are queued with submit() and advanced by poll(), one bus
+    operation per call, without waiting on the hardware. Call poll() from
+    loop() (or a timer/TWI interrupt) as often as convenient. On buses that
+    only move whole messages (TwiMaster on Wire), each transfer is one
+    burst, started by postTransfer() from poll().
+*/
+class I2cAsync {
+  public:
+    explicit I2cAsync(I2cMasterBase* bus);
+    bool submit(I2cTransfer* transfer);
+    bool poll(void);
+    /** \return true while transfers are queued or in progress */
+    bool busy(void) {
+        return head_ != 0;
+    }
+  private:
+    I2cAsync() {}
+    void complete(int8_t status);
+    I2cMasterBase* bus_;
+    I2cTransfer* head_;
+    I2cTransfer* tail_;
+    uint8_t state_;
+    uint8_t index_;
+    int8_t status_;
 };
 #endif  // I2C_MASTER_H
@@ -4,6 +4,8 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <I2cMaster.h>
+#include <MLX90615Crc.h>
+#include <MLX90615Transport.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -19,56 +21,126 @@
 
 #define MLX90615_SLEEP	0xC6
 
+// Wake-up from sleep: SCL held low for more than 39 ms, then conversions
+// are not valid until the device settled (longer with more IIR filtering)
+#ifndef MLX90615_WAKE_PULSE_MS
+    #define MLX90615_WAKE_PULSE_MS      50
+#endif
+#ifndef MLX90615_WAKE_SETTLE_MS
+    #define MLX90615_WAKE_SETTLE_MS     300
+#endif
+// Time between two conversions, nominal: settling times scale with it
+#ifndef MLX90615_CONVERSION_MS
+    #define MLX90615_CONVERSION_MS      10
+#endif
+
 // DEPRECATED! (just emissivity, not the whole EEPROM)
 #define AccessEEPROM                    MLX90615_EEPROM_EMISSIVITY
 
 #define Default_Emissivity              0x4000
 #define MLX90615_DefaultAddr			0x5B
 
+// Units of the integer temperature API (getTemperatureInt, rawToInt)
+#define MLX90615_CENTI_CELSIUS          0   // 0.01 °C
+#define MLX90615_CENTI_FAHRENHEIT       1   // 0.01 °F
+#define MLX90615_KELVIN_X50             2   // Raw register scale, 0.02 K
+
+// Extra attempts of readReg/readAll after a PEC mismatch or a Nak
+#define MLX90615_DEFAULT_RETRIES        2
+
 // DEPRECATED! (too ambiguous in some setups)
 #define DEVICE_ADDR                     MLX90615_DefaultAddr
 
-class MLX90615 {
+/**
+    Raw content of the three RAM registers, as filled by readAll()
+*/
+struct MLX90615Data {
+    uint16_t rawIr;     // MLX90615_RAW_IR_DATA
+    uint16_t ambient;   // MLX90615_AMBIENT_TEMPERATURE
+    uint16_t object;    // MLX90615_OBJECT_TEMPERATURE
+};
+
+/**
+    Register read queued on an I2cAsync engine, see readRegAsync()
+*/
+struct MLX90615AsyncRead {
+    I2cTransfer transfer;
+    uint8_t cmd;
+    uint8_t data[3];    // lsb, msb, pec
+};
+
+/**
+    Per device error counters, see getStats()
+*/
+struct MLX90615Stats {
+    uint32_t reads;         // Registers requested by readReg/readAll
+    uint32_t crcErrors;     // Words received with a bad PEC
+    uint32_t naks;          // Transactions not acknowledged
+    uint32_t retries;       // Extra attempts made after an error
+};
+
+/**
+    MLX90615 driver with the bus transport bound at compile time, so bus
+    primitives are called directly (and inlined) instead of through
+    virtual calls and a Wire/I2cMasterBase test on every access.
+    Transport: MLX90615WireTransport, MLX90615SoftI2cTransport,
+    MLX90615TwiTransport, MLX90615SimTransport (MLX90615Sim.h) or any
+    class with the same members (see MLX90615Transport.h).
+*/
+template <class Transport>
+class MLX90615T {
 
   protected:
-    TwoWire* wbus;
-    I2cMasterBase* bus;
-
-    union {
-        uint8_t	buffer[5];
-        struct {
-            union {
-                uint8_t dev;
-                struct {
-                    uint8_t             : 1;
-                    uint8_t i2c_addr    : 7;
-                };
-            };
-            uint8_t cmd;
-            uint8_t dataLow;
-            uint8_t dataHigh;
-            uint8_t pec;
-        };
-    };
+    Transport transport;
+
+    uint8_t dev;            // 8-bit address, write
+    uint8_t retries;
+    MLX90615Stats stats;
 
   public:
 
-    /*******************************************************************
-        Function Name: init
-        Description:  initialize for i2c device.
-        Parameters: sda pin, scl pin, i2c device address
-        Return: null
-    ******************************************************************/
-    MLX90615(uint8_t addr, I2cMasterBase* i2c) {
+    MLX90615T(uint8_t addr, const Transport& i2c) : transport(i2c) {
         dev = addr << 1;
-        bus = i2c;
-        wbus = 0;
+        retries = MLX90615_DEFAULT_RETRIES;
+        resetStats();
     }
 
-    MLX90615(uint8_t addr, TwoWire* i2c) {
+    /** Shorthand: MLX90615T<MLX90615WireTransport> mlx(addr, &Wire) */
+    template <class Bus>
+    MLX90615T(uint8_t addr, Bus* i2c) : transport(i2c) {
         dev = addr << 1;
-        bus = 0;
-        wbus = i2c;
+        retries = MLX90615_DEFAULT_RETRIES;
+        resetStats();
+    }
+
+    /**
+        Set how many times readReg/readAll try again after a bad PEC or a
+        Nak before giving up (0 disables retries)
+    */
+    void setRetries(uint8_t count) {
+        retries = count;
+    }
+
+    /** Error counters since construction or resetStats() */
+    const MLX90615Stats& getStats() {
+        return stats;
+    }
+
+    void resetStats() {
+        stats.reads = 0;
+        stats.crcErrors = 0;
+        stats.naks = 0;
+        stats.retries = 0;
+    }
+
+    /**
+        Check the PEC of a read word frame: address (write), command,
+        address (read), lsb, msb
+        @return: true when pec matches
+    */
+    static bool checkPec(uint8_t dev, uint8_t cmd, uint8_t lsb, uint8_t msb, uint8_t pec) {
+        uint8_t frame[5] = {(uint8_t)(dev & ~I2C_READ), cmd, (uint8_t)(dev | I2C_READ), lsb, msb};
+        return mlx90615Crc8(0x00, frame, 5) == pec;
     }
 
     /****************************************************************
@@ -76,8 +148,13 @@ class MLX90615 {
         Description:  CRC8 check to compare PEC data
         Parameters: poly - x8+x2+x1+1, data - array to check, array size
         Return: 0 – data right; 1 – data Error
+        (SMBus poly 0x07 uses the MLX90615_CRC8_IMPL table, see MLX90615Crc.h)
     ****************************************************************/
-    uint8_t crc8Msb(uint8_t poly, uint8_t* data, int size)	{
+    static uint8_t crc8Msb(uint8_t poly, uint8_t* data, int size)	{
+        if (poly == MLX90615_PEC_POLY) {
+            return mlx90615Crc8(0x00, data, size);
+        }
+
         uint8_t crc = 0x00;
         int bit;
 
@@ -103,19 +180,299 @@ class MLX90615 {
         Return:  true for ok, false for failure
     */
     float getTemperature(int Temperature_kind, bool fahrenheit = false) {
-        float celsius;
-        uint16_t tempData;
+        uint16_t tempData = 0;
 
         readReg(Temperature_kind, &tempData);
 
-        double tempFactor = 0.02; // 0.02 degrees per LSB (measurement resolution of the MLX90614)
+        return rawToTemperature(tempData, fahrenheit);
+    }
+
+    /**
+        Convert a raw ambient/object register value (as read by readReg
+        or readAll) to Celcius or Fahrenheit
+    */
+    static float rawToTemperature(uint16_t tempData, bool fahrenheit = false) {
+        if (fahrenheit) {
+            return rawToInt<MLX90615_CENTI_FAHRENHEIT>(tempData) / 100.0;
+        }
+        return rawToInt<MLX90615_CENTI_CELSIUS>(tempData) / 100.0;
+    }
 
-        // This masks off the error bit of the high byte
-        celsius = ((float)tempData * tempFactor) - 0.01;
+    /**
+        Get temperature with integer math only (no float/double code is
+        pulled in unless the float API is used as well)
+        Parameters:
+        > unit: MLX90615_CENTI_CELSIUS, MLX90615_CENTI_FAHRENHEIT or MLX90615_KELVIN_X50
+        > Temperature_kind: MLX90615_AMBIENT_TEMPERATURE or MLX90615_OBJECT_TEMPERATURE
+        > value: where to store the temperature
+        Return: same as readReg()
+    */
+    template <uint8_t unit>
+    int getTemperatureInt(int Temperature_kind, int32_t* value) {
+        uint16_t tempData;
 
-        celsius = (float)(celsius - 273.15);
+        int status = readReg(Temperature_kind, &tempData);
+        if (!status) {
+            *value = rawToInt<unit>(tempData);
+        }
+        return status;
+    }
 
-        return fahrenheit ? (celsius * 1.8) + 32.0 : celsius;
+    /**
+        Convert a raw ambient/object register value to an integer unit,
+        folded to a single expression for each unit at compile time.
+        0.02 K per LSB, minus the 0.01 K offset of the float API:
+        > centi °C = raw * 2 - 27316
+        > centi °F = (raw * 18 + 158) / 5 - 46000, i.e. (raw * 18 - 229844) / 5
+          rounded to nearest, with the division kept on positive values
+    */
+    template <uint8_t unit>
+    static constexpr int32_t rawToInt(uint16_t tempData) {
+        return unit == MLX90615_KELVIN_X50 ? (int32_t)tempData :
+               unit == MLX90615_CENTI_FAHRENHEIT ? ((int32_t)tempData * 18 + 158) / 5 - 46000 :
+               (int32_t)tempData * 2 - 27316;
+    }
+
+    /**
+        Convert an integer unit back to a raw temperature (0.02 K per LSB),
+        rounded to nearest and clamped to 0 .. 0x7FFF. The exact inverse of
+        rawToInt(): intToRaw(rawToInt(raw)) == raw for raw 0 .. 0x7FFF.
+        > raw = ((centi °F + 46000) * 5 - 156 + 9) / 18
+    */
+    template <uint8_t unit>
+    static constexpr uint16_t intToRaw(int32_t value) {
+        return unit == MLX90615_KELVIN_X50 ? clampRaw(value) :
+               unit == MLX90615_CENTI_FAHRENHEIT ? clampRaw(((value + 46000) * 5 - 147) / 18) :
+               clampRaw((value + 27317) / 2);
+    }
+
+    static constexpr uint16_t clampRaw(int32_t raw) {
+        return raw < 0 ? 0 : raw > 0x7FFF ? 0x7FFF : (uint16_t)raw;
+    }
+
+    /**
+        Read a MLX90615 register.
+        @param MLXaddr: MLX90615 EEPROM/RAM address
+        @param result: Pointer to variable to store the readed value
+        @return: status:   0  OK
+                         -1  Bad CRC calc
+                         -2  I2C Error
+                        -10  I2C Connector not specified yet
+    */
+    int readReg(uint8_t MLXaddr, uint16_t* resultReg) {
+        I2C_TRACE_BEGIN();
+        int status;
+        uint8_t attempt = 0;
+
+        stats.reads++;
+        while ((status = readWord(MLXaddr, resultReg, true, true)) && retry(status, &attempt));
+        I2C_TRACE_END(I2C_PHASE_READ, status == 0);
+        return status;
+    }
+
+    /**
+        Read raw IR, ambient and object registers in a single bus session:
+        one start and one stop, with repeated starts in between, instead of
+        three separate readReg calls.
+        @param data: Where to store the three raw values
+        @return: status, as readReg()
+    */
+    int readAll(MLX90615Data* data) {
+        I2C_TRACE_BEGIN();
+        int status;
+        uint8_t attempt = 0;
+
+        stats.reads += 3;
+        do {
+            status = readWord(MLX90615_RAW_IR_DATA, &data->rawIr, true, false);
+            if (!status) {
+                status = readWord(MLX90615_AMBIENT_TEMPERATURE, &data->ambient, false, false);
+            }
+            if (!status) {
+                status = readWord(MLX90615_OBJECT_TEMPERATURE, &data->object, false, true);
+            }
+        } while (status && retry(status, &attempt));
+        I2C_TRACE_END(I2C_PHASE_READ, status == 0);
+        return status;
+    }
+
+    /**
+        Read one register count times in a single bus session: one start,
+        repeated starts in between, one stop. Not retried.
+        @param values: Where to store the count values
+        @param count: Number of reads
+        @param done: Pointer to store the number of values read before an error
+        @return: status, as readReg()
+    */
+    int readBurst(uint8_t MLXaddr, uint16_t* values, uint8_t count, uint8_t* done) {
+        I2C_TRACE_BEGIN();
+        int status = 0;
+        uint8_t i = 0;
+
+        stats.reads += count;
+        while (i < count && !(status = readWord(MLXaddr, &values[i], i == 0, i == count - 1))) {
+            i++;
+        }
+        if (status == -1) {
+            stats.crcErrors++;
+        } else if (status == -2) {
+            stats.naks++;
+        }
+        *done = i;
+        I2C_TRACE_END(I2C_PHASE_READ, status == 0);
+        return status;
+    }
+
+  protected:
+
+    /**
+        Account for a failed attempt
+        @return: true if another attempt should be made
+    */
+    bool retry(int status, uint8_t* attempt) {
+        if (status == -1) {
+            stats.crcErrors++;
+        } else if (status == -2) {
+            stats.naks++;
+        } else {
+            return false;
+        }
+        if (*attempt >= retries) {
+            return false;
+        }
+        (*attempt)++;
+        stats.retries++;
+        return true;
+    }
+
+    /**
+        Read one word as part of a bus session and check its PEC.
+        @param first: open the session with a start (else a repeated start)
+        @param last: close the session with a stop (else keep the bus)
+        @return: status, as readReg()
+    */
+    int readWord(uint8_t MLXaddr, uint16_t* resultReg, bool first, bool last) {
+        MLX90615Transaction t;
+        mlx90615Read(&t, dev >> 1, MLXaddr);
+        int status = mlx90615Execute(transport, &t, first, last);
+        if (!status) {
+            *resultReg = mlx90615Value(&t);
+        }
+        return status;
+    }
+
+  public:
+
+    /**
+        Write a MLX90615 register. If its an EEPROM register,
+        please call twice: first with 0x0000, second with desired value
+        @param MLXaddr: MLX90615 EEPROM/RAM address
+        @param value: ... to be writen
+        @return: status:   0  OK (the PEC is sent, not checked back)
+                         -2  I2C Error
+                        -10  I2C Connector not specified yet
+    */
+    int writeReg(uint8_t MLXaddr, uint16_t value) {
+        MLX90615Transaction t;
+        mlx90615Write(&t, dev >> 1, MLXaddr, value);
+
+        I2C_TRACE_BEGIN();
+        int status = mlx90615Execute(transport, &t, true, true);
+        if (status == -2) {
+            stats.naks++;
+        }
+        I2C_TRACE_END(I2C_PHASE_WRITE, status == 0);
+        return status;
+    }
+
+    /**
+        Quick presence test: address the device and stop, no data
+        @return: status:   0  Acked
+                         -2  I2C Error (Nak)
+                        -10  I2C Connector not specified yet
+    */
+    int probe() {
+        return transport.writeBytes(dev, 0, 0);
+    }
+
+    /**
+        Run a list of transactions on the bus of this device, for any
+        device on it (see mlx90615Submit()). Not counted in getStats().
+        @return: 0 if all succeeded, else the status of the last failure
+    */
+    int submit(MLX90615Transaction* list, uint8_t count) {
+        return mlx90615Submit(transport, list, count);
+    }
+
+    /**
+        Free a bus left stuck by an interrupted transfer: clock SCL until
+        the slave holding SDA low releases it, then issue a stop
+        @return: status:   0  Bus free
+                         -2  SDA still held low after I2C_RECOVER_CLOCKS clocks
+    */
+    int recover() {
+        return transport.recover() ? 0 : -2;
+    }
+
+    /**
+        Put the device in sleep mode. It does not answer on the bus until
+        woken up, see beginWake()
+        @return: status:   0  OK
+                         -2  I2C Error
+                        -10  I2C Connector not specified yet
+    */
+    int sleep() {
+        uint8_t frame[2] = {MLX90615_SLEEP, mlx90615CommandPec(dev >> 1, MLX90615_SLEEP)};
+        int status = transport.writeBytes(dev, frame, 2);
+        if (status == -2) {
+            stats.naks++;
+        }
+        return status;
+    }
+
+    /**
+        Start the wake-up pulse: SCL is held low until endWake(), which must
+        be at least MLX90615_WAKE_PULSE_MS later. Every sleeping device on
+        the bus wakes up. The bus can't be used in between.
+    */
+    void beginWake() {
+        transport.holdScl(true);
+    }
+
+    /**
+        End the wake-up pulse. Readings are valid MLX90615_WAKE_SETTLE_MS later.
+    */
+    void endWake() {
+        transport.holdScl(false);
+    }
+
+    /** Wake-up pulse, blocking for MLX90615_WAKE_PULSE_MS */
+    void wake() {
+        beginWake();
+        delay(MLX90615_WAKE_PULSE_MS);
+        endWake();
+    }
+};
+
+/**
+    MLX90615 on a Wire or I2cMasterBase bus chosen at run time
+*/
+class MLX90615 : public MLX90615T<MLX90615AnyTransport> {
+
+  public:
+
+    /*******************************************************************
+        Function Name: init
+        Description:  initialize for i2c device.
+        Parameters: sda pin, scl pin, i2c device address
+        Return: null
+    ******************************************************************/
+    MLX90615(uint8_t addr, I2cMasterBase* i2c) :
+        MLX90615T<MLX90615AnyTransport>(addr, MLX90615AnyTransport(i2c)) {
+    }
+
+    MLX90615(uint8_t addr, TwoWire* i2c) :
+        MLX90615T<MLX90615AnyTransport>(addr, MLX90615AnyTransport(i2c)) {
     }
 
     // DEPRECATED (use getTemperature)
@@ -156,43 +513,57 @@ class MLX90615 {
     }
 
     /**
-        Read a MLX90615 register.
+        Queue a register read on a non-blocking engine and return at once.
+        Only for devices created with an I2cMasterBase (the engine's bus).
+        @param engine: I2cAsync driving the bus of this device
         @param MLXaddr: MLX90615 EEPROM/RAM address
-        @param result: Pointer to variable to store the readed value
-        @return: status:   0  OK
+        @param request: Caller-owned, zero-initialized before first use; must
+                        stay valid until readRegResult() is no longer 1
+        @param callback: Optional, called from engine->poll() on completion
+        @return: status:   0  Queued
+                          1  This request is still pending
+                        -10  Not using an I2cMasterBase bus
+    */
+    int readRegAsync(I2cAsync* engine, uint8_t MLXaddr, MLX90615AsyncRead* request,
+                     void (*callback)(I2cTransfer*) = 0) {
+        if (!transport.getBus() || transport.getWire()) {
+            return -10;
+        }
+        if (request->transfer.status == I2C_PENDING) {
+            return 1;
+        }
+        request->cmd = MLXaddr;
+        request->transfer.address = dev >> 1;
+        request->transfer.tx = &request->cmd;
+        request->transfer.txLen = 1;
+        request->transfer.rx = request->data;
+        request->transfer.rxLen = 3;
+        request->transfer.callback = callback;
+        request->transfer.context = this;
+        engine->submit(&request->transfer);
+        return 0;
+    }
+
+    /**
+        Outcome of a readRegAsync() request. Not retried: on error, call
+        readRegAsync() again.
+        @param resultReg: Pointer to variable to store the readed value
+        @return: status:   1  Still pending
+                          0  OK
                          -1  Bad CRC calc
                          -2  I2C Error
-                        -10  I2C Connector not specified yet
     */
-    int readReg(uint8_t MLXaddr, uint16_t* resultReg) {
-        if (bus && !wbus) {
-            // Using alternative I2C library
-            bus->start(dev | I2C_WRITE);
-            bus->write(MLXaddr);
-            bus->restart(dev | I2C_READ);
-            dataLow = bus->read(false);
-            dataHigh = bus->read(false);
-            *resultReg = (uint16_t)dataHigh << 8 | dataLow;
-            pec = bus->read(true);
-            bus->stop();
-            return 0;
-        } else if (wbus && !bus) {
-            // Using Wire
-            wbus->beginTransmission(i2c_addr);
-            wbus->write(MLXaddr);
-            wbus->endTransmission(false);
-            if (wbus->requestFrom(i2c_addr, (uint8_t)3) == 3) {
-                dataLow = wbus->read();
-                dataHigh = wbus->read();
-                pec = wbus->read();
-                *resultReg = dataHigh << 8 | dataLow;
-                return 0;
-            } else {
-                return -2;
-            }
-        } else {
-            return -10;
+    static int readRegResult(MLX90615AsyncRead* request, uint16_t* resultReg) {
+        int status = request->transfer.status;
+        if (status != I2C_DONE) {
+            return status;
         }
+        if (!checkPec(request->transfer.address << 1, request->cmd,
+                      request->data[0], request->data[1], request->data[2])) {
+            return -1;
+        }
+        *resultReg = (uint16_t)request->data[1] << 8 | request->data[0];
+        return 0;
     }
 
     /**
@@ -217,56 +588,6 @@ class MLX90615 {
         return res;
     }
 
-    /**
-        Write a MLX90615 register. If its an EEPROM register,
-        please call twice: first with 0x0000, second with desired value
-        @param MLXaddr: MLX90615 EEPROM/RAM address
-        @param value: ... to be writen
-        @return: status:   0  OK
-                         -1  Bad CRC calc
-                         -2  I2C Error
-                        -10  I2C Connector not specified yet
-    */
-    int writeReg(uint8_t MLXaddr, uint16_t value) {
-        // CRC calculation
-        cmd = MLXaddr;
-        dataLow = value & 0xff;
-        dataHigh = (value >> 8) & 0xff;
-        pec = crc8Msb(0x07, buffer, 4);
-        if (crc8Msb(0x07, buffer, 5)) {
-            return -1;
-        }
-
-        int sent = 0;
-        if (bus && !wbus) {
-            // Using alternative I2C library
-            bus->start(dev | I2C_WRITE);
-            for (int i = 1 ; i <= 4  ; i++) {
-                if (bus->write(buffer[i])) {
-                    sent++;
-                } else {
-                    break;
-                }
-            }
-            bus->stop();
-            if (sent != 4) {
-                return -2;
-            }
-            return 0;
-        } else if (wbus && !bus) {
-            // Using Wire
-            wbus->beginTransmission(i2c_addr);
-            sent = wbus->write(&buffer[1], 4);
-            wbus->endTransmission();
-            if (sent != 4) {
-                return -2;
-            }
-            return 0;
-        } else {
-            return -10;
-        }
-    }
-
     /**
         Function Name: writeReg8 - DEPRECATED! (use writeReg)
         Description:  i2c write register one byte
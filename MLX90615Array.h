@@ -0,0 +1,217 @@
+#ifndef __MLX90615_ARRAY_H__
+#define __MLX90615_ARRAY_H__
+
+#include <Arduino.h>
+#include <MLX90615.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Circuit breaker: consecutive failures before a device is skipped
+#ifndef MLX90615_BREAKER_THRESHOLD
+#define MLX90615_BREAKER_THRESHOLD  3
+#endif
+// First back-off, doubled on each further failure up to the maximum
+#ifndef MLX90615_BACKOFF_MIN_MS
+#define MLX90615_BACKOFF_MIN_MS     10
+#endif
+#ifndef MLX90615_BACKOFF_MAX_MS
+#define MLX90615_BACKOFF_MAX_MS     5000
+#endif
+
+/**
+    Last sample and timing statistics of one device in a MLX90615Array
+*/
+struct MLX90615Channel {
+    MLX90615* device;
+    MLX90615Data data;      // Last raw sample (see MLX90615::rawToTemperature)
+    int status;             // readAll() status of the last sample
+    uint32_t timestamp;     // Clock value when the last sample was taken
+    uint32_t samples;
+    uint32_t interval8;     // Smoothed time between samples, us * 8
+    uint32_t jitter8;       // Smoothed deviation from interval, us * 8
+    uint8_t failures;       // Consecutive failed samples
+    uint32_t retryAt;       // Clock value of the next trial while tripped
+    uint32_t trips;         // Times the breaker opened
+};
+
+/**
+    Round-robin scheduler for several MLX90615 on a shared bus.
+
+    Instead of reading every device and then delay()ing, call poll() from
+    loop(): it reads the next device whenever its slot is due, so reads
+    are spread at a fixed cadence (or packed back to back) and loop()
+    stays free for other work in between.
+
+    A device failing MLX90615_BREAKER_THRESHOLD times in a row (bus error,
+    bad PEC) trips its circuit breaker: the bus is recovered after each
+    bus error (nak, timeout), and the device is then left out of the rotation for a back-off
+    (MLX90615_BACKOFF_MIN_MS, doubled on each further failure up to
+    MLX90615_BACKOFF_MAX_MS) before a single trial read. Its slots go to the
+    healthy devices meanwhile, so a dead sensor, whose reads may each cost
+    a bus timeout, does not slow down the others.
+
+    N is the capacity of the device table.
+*/
+template <uint8_t N>
+class MLX90615Array {
+
+  protected:
+    MLX90615Channel channels[N];
+    uint8_t count;
+    uint8_t next;
+    uint32_t period;        // us between two reads (any device), 0 = back to back
+    uint32_t due;
+    uint32_t (*clock)(void);
+
+    static uint32_t defaultClock(void) {
+        return micros();
+    }
+
+    void sample(MLX90615Channel* ch, uint32_t now) {
+        ch->status = ch->device->readAll(&ch->data);
+        if (ch->samples) {
+            uint32_t elapsed = now - ch->timestamp;
+            if (ch->samples == 1) {
+                ch->interval8 = elapsed * 8;
+            }
+            // Exponential averages, weight 1/8, kept scaled by 8
+            int32_t error = (int32_t)(elapsed - ch->interval8 / 8);
+            ch->interval8 += error;
+            ch->jitter8 += (error < 0 ? -error : error) - ch->jitter8 / 8;
+        }
+        ch->timestamp = now;
+        ch->samples++;
+        if (ch->status == 0 || ch->status == -10) {
+            ch->failures = 0;
+            return;
+        }
+        if (ch->status == -2) {
+            // Free the bus for the others, in case the device holds SDA;
+            // a bad PEC came over a working bus, which needs no recovery
+            ch->device->recover();
+        }
+        if (ch->failures < 255) {
+            ch->failures++;
+        }
+        if (ch->failures >= MLX90615_BREAKER_THRESHOLD) {
+            uint8_t shift = ch->failures - MLX90615_BREAKER_THRESHOLD;
+            uint32_t backoff = MLX90615_BACKOFF_MAX_MS;
+            if (shift < 16 && ((uint32_t)MLX90615_BACKOFF_MIN_MS << shift) < backoff) {
+                backoff = (uint32_t)MLX90615_BACKOFF_MIN_MS << shift;
+            }
+            ch->retryAt = clock() + backoff * 1000;
+            if (!shift) {
+                ch->trips++;
+            }
+        }
+    }
+
+    bool blocked(MLX90615Channel* ch, uint32_t now) {
+        return ch->failures >= MLX90615_BREAKER_THRESHOLD && (int32_t)(now - ch->retryAt) < 0;
+    }
+
+  public:
+
+    MLX90615Array() {
+        count = 0;
+        next = 0;
+        period = 0;
+        due = 0;
+        clock = defaultClock;
+    }
+
+    /**
+        Add a device to the table
+        @return: index of the device, or -1 when the table is full
+    */
+    int add(MLX90615* device) {
+        if (count >= N) {
+            return -1;
+        }
+        MLX90615Channel* ch = &channels[count];
+        ch->device = device;
+        ch->status = -10;
+        ch->timestamp = 0;
+        ch->samples = 0;
+        ch->interval8 = 0;
+        ch->jitter8 = 0;
+        ch->failures = 0;
+        ch->retryAt = 0;
+        ch->trips = 0;
+        return count++;
+    }
+
+    /**
+        Set the aggregate target rate: reads per second over all devices,
+        so each device is sampled at samplesPerSecond / size().
+        0 (default) reads back to back as fast as the bus allows.
+    */
+    void setRate(uint32_t samplesPerSecond) {
+        period = samplesPerSecond ? 1000000UL / samplesPerSecond : 0;
+        due = clock();
+    }
+
+    /** Replace micros() as time base (e.g. a simulated bus clock). */
+    void setClock(uint32_t (*us)(void)) {
+        clock = us;
+        due = clock();
+    }
+
+    /**
+        Read the next device if its slot is due, skipping the devices whose
+        breaker is open. Never waits.
+        @return: index of the device read, or -1 if nothing was due
+    */
+    int poll() {
+        if (!count) {
+            return -1;
+        }
+        uint32_t now = clock();
+        if (period && (int32_t)(now - due) < 0) {
+            return -1;
+        }
+        uint8_t index = next;
+        for (uint8_t skipped = 0; blocked(&channels[index], now); ) {
+            index = (index + 1) % count;
+            if (++skipped == count) {
+                return -1;
+            }
+        }
+        if (period) {
+            due += period;
+            if ((int32_t)(now - due) >= 0) {
+                // Fell behind by more than a slot: resync rather than burst
+                due = now + period;
+            }
+        }
+        sample(&channels[index], now);
+        next = (index + 1) % count;
+        return index;
+    }
+
+    uint8_t size() {
+        return count;
+    }
+
+    MLX90615Channel* channel(uint8_t index) {
+        return &channels[index];
+    }
+
+    /** Achieved sample rate of one device, in samples per second. */
+    float rate(uint8_t index) {
+        uint32_t interval8 = channels[index].interval8;
+        return interval8 ? 8000000.0 / interval8 : 0;
+    }
+
+    /** True while the breaker of one device is open (or half-open, awaiting its trial). */
+    bool tripped(uint8_t index) {
+        return channels[index].failures >= MLX90615_BREAKER_THRESHOLD;
+    }
+
+    /** Smoothed sample timing jitter of one device, in us. */
+    uint32_t jitter(uint8_t index) {
+        return channels[index].jitter8 / 8;
+    }
+};
+
+#endif // __MLX90615_ARRAY_H__
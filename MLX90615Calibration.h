@@ -0,0 +1,191 @@
+#ifndef __MLX90615_CALIBRATION_H__
+#define __MLX90615_CALIBRATION_H__
+
+#include <Arduino.h>
+#include <MLX90615.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+    Emissivity, reflected ambient and gain/offset correction of the object
+    temperature, done on the host instead of rewriting the EEPROM.
+
+    The device computes To from the IR signal with its EEPROM emissivity
+    e0. For a target of emissivity e, reflecting a background at Tr (the
+    sensor ambient Ta by default), the target temperature Tt is:
+
+        Tt^4 = Tr^4 + (e0 / e) * (To^4 - Ta^4) + (1 / e) * (Ta^4 - Tr^4)
+
+    then Tt' = gain * (Tt - 0 °C) + 0 °C + offset. All temperatures stay in
+    raw register units (0.02 K), T^4 in 64-bit integers, and the 4th root
+    is two integer square roots. Coefficients are fixed point, computed
+    once (at compile time for constant profiles), so switching profiles is
+    a pointer change instead of a 20 ms EEPROM erase/write cycle.
+
+    Accuracy against a double precision evaluation of the same formula,
+    for objects -40 .. 160 °C and ambients -40 .. 85 °C (extras/test):
+    > e = 0.95                          0.50 LSB (the final rounding)
+    > e = 0.60, reflected 40 °C         0.53 LSB, where Tt nears 0 K
+    > e = 0.30, gain 1.02, -0.5 °C      0.51 LSB
+    > e = 0.10, reflected 100 °C        0.50 LSB
+    The coefficients are Q24 and the 4th root keeps 8 fraction bits until
+    the gain is applied: with Q16 coefficients and an integer root, low
+    emissivities lost up to 2 LSB.
+*/
+
+// Reflected temperature of a profile: use the sensor ambient
+#define MLX90615_REFLECTED_AMBIENT  -300.0
+
+/**
+    Precomputed correction coefficients, see mlx90615Profile()
+*/
+struct MLX90615Profile {
+    uint32_t scale;         // e0 / e, Q24
+    uint32_t inverse;       // 1 / e, Q24
+    uint32_t gain;          // Q24, 0x1000000 = 1
+    uint16_t reflected;     // Raw reflected temperature, 0 = sensor ambient
+    int16_t offset;         // Raw LSB (0.02 K)
+};
+
+/**
+    Build a profile, at compile time when the arguments are constant
+    @param emissivity: Target emissivity, 0.1 .. 1.0
+    @param gain: Slope correction around 0 °C
+    @param offset: Offset correction in °C
+    @param reflected: Reflected background temperature in °C, or
+                      MLX90615_REFLECTED_AMBIENT for the sensor ambient
+    @param sensorEmissivity: Emissivity in the device EEPROM (raw, 0x4000 = 1)
+*/
+constexpr MLX90615Profile mlx90615Profile(float emissivity, float gain = 1.0, float offset = 0.0,
+                                          float reflected = MLX90615_REFLECTED_AMBIENT,
+                                          uint16_t sensorEmissivity = Default_Emissivity) {
+    return MLX90615Profile {
+        (uint32_t)(sensorEmissivity * 1024.0 / emissivity + 0.5),
+        (uint32_t)(16777216.0 / emissivity + 0.5),
+        (uint32_t)(gain * 16777216.0 + 0.5),
+        (uint16_t)(reflected < -273.0 ? 0 : reflected * 50 + 13658 + 0.5),
+        (int16_t)(offset * 50 + (offset < 0 ? -0.5 : 0.5))
+    };
+}
+
+/**
+    Object temperature correction for one device, with a switchable profile
+*/
+class MLX90615Compensator {
+
+  protected:
+    MLX90615* device;
+    const MLX90615Profile* profile;
+
+    static uint64_t pow4(uint16_t raw) {
+        uint32_t square = (uint32_t)raw * raw;
+        return (uint64_t)square * square;
+    }
+
+    static uint32_t isqrt(uint64_t x) {
+        uint64_t root = 0;
+        uint64_t bit = 1ULL << 62;
+        while (bit > x) {
+            bit >>= 2;
+        }
+        while (bit) {
+            if (x >= root + bit) {
+                x -= root + bit;
+                root = (root >> 1) + bit;
+            } else {
+                root >>= 1;
+            }
+            bit >>= 2;
+        }
+        return root;
+    }
+
+  public:
+
+    /**
+        @param mlx: Device read by the read functions, may be 0 when only
+                    compensate() is used
+        @param p: Profile, 0 for no correction
+    */
+    explicit MLX90615Compensator(MLX90615* mlx, const MLX90615Profile* p = 0) {
+        device = mlx;
+        profile = p;
+    }
+
+    /** Switch profile (e.g. another target material), 0 for no correction */
+    void setProfile(const MLX90615Profile* p) {
+        profile = p;
+    }
+
+    const MLX90615Profile* getProfile() {
+        return profile;
+    }
+
+    /**
+        Corrected object temperature
+        @param p: Profile
+        @param object, ambient: Raw object and ambient temperatures
+        @return: raw corrected object temperature (see MLX90615::rawToInt)
+    */
+    static uint16_t compensate(const MLX90615Profile* p, uint16_t object, uint16_t ambient) {
+        // Bit 15 is the error flag: also keeps T^4 within int64
+        object &= 0x7FFF;
+        ambient &= 0x7FFF;
+        int64_t o4 = pow4(object);
+        int64_t a4 = pow4(ambient);
+        int64_t r4 = p->reflected ? pow4(p->reflected) : a4;
+
+        // Tt^4 / 16, so that the products stay within int64
+        int64_t x = r4 / 16 + (o4 - a4) / (1L << 28) * p->scale + (a4 - r4) / (1L << 28) * p->inverse;
+        if (x <= 0) {
+            return 0;
+        }
+        if (x >= (int64_t)1 << 59) {
+            return 0x7FFF;
+        }
+        x *= 16;
+
+        // 4th root with 8 fraction bits (linear between integer roots),
+        // rounded only once, after the gain
+        uint32_t t = isqrt(isqrt(x));
+        uint64_t t4 = pow4(t);
+        uint32_t fraction = (((uint64_t)x - t4) << 8) / (pow4(t + 1) - t4);
+
+        int64_t celsius = ((int64_t)t << 8) + fraction - ((int64_t)13658 << 8);
+        int32_t result = (int32_t)((celsius * p->gain + ((int64_t)1 << 31)) >> 32) + 13658 + p->offset;
+        return result < 0 ? 0 : result > 0x7FFF ? 0x7FFF : result;
+    }
+
+    /**
+        Read the device and correct the object temperature with the profile
+        @param resultReg: Pointer to store the raw corrected temperature
+        @return: status, as readAll()
+    */
+    int readObject(uint16_t* resultReg) {
+        MLX90615Data data;
+        int status = device ? device->readAll(&data) : -10;
+        if (status) {
+            return status;
+        }
+        *resultReg = profile ? compensate(profile, data.object, data.ambient) : data.object;
+        return 0;
+    }
+
+    /**
+        Corrected object temperature in integer units
+        @param unit: MLX90615_CENTI_CELSIUS, MLX90615_CENTI_FAHRENHEIT or MLX90615_KELVIN_X50
+        @param result: Pointer to store the temperature
+        @return: status, as readAll()
+    */
+    template <uint8_t unit>
+    int getTemperatureInt(int32_t* result) {
+        uint16_t raw;
+        int status = readObject(&raw);
+        if (!status) {
+            *result = MLX90615::rawToInt<unit>(raw);
+        }
+        return status;
+    }
+};
+
+#endif // __MLX90615_CALIBRATION_H__
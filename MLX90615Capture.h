@@ -0,0 +1,155 @@
+#ifndef __MLX90615_CAPTURE_H__
+#define __MLX90615_CAPTURE_H__
+
+#include <Arduino.h>
+#include <MLX90615.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Most reads of one bus session (start ... stop) in a capture
+#define MLX90615_CAPTURE_BURST_MAX  16
+
+/**
+    High-rate capture of the raw IR channel (MLX90615_RAW_IR_DATA): reads
+    0x25 back to back into a caller buffer, as fast as the bus allows, in
+    sessions of up to `burst` reads (one start, repeated starts, one stop).
+
+    Each stored sample is the average of `decimation` reads: 1 keeps every
+    read, more trades rate for noise. A failed read (bad PEC, Nak) is
+    dropped and the sample averages the others. The raw channel reflects
+    the sensor's own conversions: reading faster than its refresh rate
+    returns repeated values, which the averaging absorbs.
+*/
+class MLX90615IrCapture {
+
+  protected:
+    MLX90615* device;
+    uint8_t decimation;
+    uint8_t burst;
+    uint32_t samples;
+    uint32_t reads;
+    uint32_t dropped;
+    uint32_t elapsed;       // us spent in capture()
+    uint32_t (*clock)(void);
+
+    static uint32_t defaultClock(void) {
+        return micros();
+    }
+
+  public:
+
+    /**
+        @param mlx: Device to read
+        @param reads: Reads averaged into each sample (decimation factor)
+        @param session: Reads per bus session, 1 .. MLX90615_CAPTURE_BURST_MAX
+    */
+    explicit MLX90615IrCapture(MLX90615* mlx, uint8_t reads = 1, uint8_t session = 8) {
+        device = mlx;
+        clock = defaultClock;
+        setDecimation(reads);
+        setBurst(session);
+        reset();
+    }
+
+    /** Replace micros() as time base (e.g. a simulated bus clock) */
+    void setClock(uint32_t (*us)(void)) {
+        clock = us;
+    }
+
+    /** Reads averaged into each sample, at least 1 */
+    void setDecimation(uint8_t reads) {
+        decimation = reads ? reads : 1;
+    }
+
+    /** Reads per bus session, 1 .. MLX90615_CAPTURE_BURST_MAX */
+    void setBurst(uint8_t session) {
+        burst = session < 1 ? 1 : session > MLX90615_CAPTURE_BURST_MAX ?
+                MLX90615_CAPTURE_BURST_MAX : session;
+    }
+
+    /** Clear the counters and the rate measurement */
+    void reset() {
+        samples = 0;
+        reads = 0;
+        dropped = 0;
+        elapsed = 0;
+    }
+
+    /**
+        Raw IR register to a signed value: bit 15 is the sign, bits 14..0
+        the magnitude
+    */
+    static int16_t rawIrToInt(uint16_t raw) {
+        return raw & 0x8000 ? -(int16_t)(raw & 0x7FFF) : (int16_t)raw;
+    }
+
+    /**
+        Fill a buffer with raw IR samples, blocking
+        @param buffer: Where to store the samples (see rawIrToInt())
+        @param count: Samples wanted
+        @return: number of samples stored; less than count if none of the
+                 reads of a sample succeeded (device gone), see getDropped()
+    */
+    uint16_t capture(int16_t* buffer, uint16_t count) {
+        uint16_t words[MLX90615_CAPTURE_BURST_MAX];
+        uint8_t pending = 0;        // Unused words of the last session
+        uint8_t next = 0;
+        uint16_t stored = 0;
+        uint32_t t0 = clock();
+
+        while (stored < count) {
+            int32_t sum = 0;
+            uint8_t good = 0;
+            for (uint8_t i = 0; i < decimation; i++) {
+                if (!pending) {
+                    // No longer session than the reads still needed
+                    uint32_t left = (uint32_t)(count - stored) * decimation - i;
+                    uint8_t n = left < burst ? left : burst;
+                    uint8_t done;
+                    // An error ends the session: the rest comes with the next one
+                    bool failed = device->readBurst(MLX90615_RAW_IR_DATA, words, n, &done) != 0;
+                    reads += done + failed;
+                    dropped += failed;
+                    if (!done) {
+                        continue;
+                    }
+                    pending = done;
+                    next = 0;
+                }
+                sum += rawIrToInt(words[next++]);
+                pending--;
+                good++;
+            }
+            if (!good) {
+                break;
+            }
+            buffer[stored++] = (sum + (sum < 0 ? -(good / 2) : good / 2)) / good;
+        }
+
+        samples += stored;
+        elapsed += clock() - t0;
+        return stored;
+    }
+
+    /** Samples per second achieved by capture() since reset() */
+    float sps() {
+        return elapsed ? samples * 1000000.0 / elapsed : 0;
+    }
+
+    /** Samples stored since reset() */
+    uint32_t getSamples() {
+        return samples;
+    }
+
+    /** Register reads issued since reset() */
+    uint32_t getReads() {
+        return reads;
+    }
+
+    /** Failed reads (bad PEC, Nak) since reset() */
+    uint32_t getDropped() {
+        return dropped;
+    }
+};
+
+#endif // __MLX90615_CAPTURE_H__
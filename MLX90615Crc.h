@@ -0,0 +1,120 @@
+#ifndef __MLX90615_CRC_H__
+#define __MLX90615_CRC_H__
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/*
+    CRC-8 with the SMBus PEC polynomial x8+x2+x1+1 (0x07), MSB first.
+
+    Three interchangeable implementations; MLX90615_CRC8_IMPL picks the one
+    used by MLX90615 (define it before including MLX90615.h):
+    > MLX90615_CRC8_BITWISE: no table, 8 shifts per byte
+    > MLX90615_CRC8_NIBBLE:  16 byte table in flash, 2 lookups per byte
+    > MLX90615_CRC8_TABLE:   256 byte table in flash, 1 lookup per byte
+*/
+
+#define MLX90615_CRC8_BITWISE   0
+#define MLX90615_CRC8_NIBBLE    1
+#define MLX90615_CRC8_TABLE     2
+
+#ifndef MLX90615_CRC8_IMPL
+    #define MLX90615_CRC8_IMPL  MLX90615_CRC8_TABLE
+#endif
+
+#define MLX90615_PEC_POLY       0x07
+
+/**
+    Shift bits of crc through the polynomial, at compile time if possible
+*/
+constexpr uint8_t mlx90615Crc8Shift(uint8_t crc, uint8_t bits) {
+    return bits == 0 ? crc :
+           mlx90615Crc8Shift((crc & 0x80) ? (uint8_t)((crc << 1) ^ MLX90615_PEC_POLY) : (uint8_t)(crc << 1),
+                             bits - 1);
+}
+
+/** Add one byte to a running CRC, at compile time if possible */
+constexpr uint8_t mlx90615Crc8(uint8_t crc, uint8_t data) {
+    return mlx90615Crc8Shift(crc ^ data, 8);
+}
+
+/**
+    PEC of a MLX90615 write word frame (address, command, lsb, msb), so
+    frames with constant content cost nothing at run time
+*/
+constexpr uint8_t mlx90615WritePec(uint8_t addr, uint8_t cmd, uint16_t value) {
+    return mlx90615Crc8(mlx90615Crc8(mlx90615Crc8(mlx90615Crc8(0, addr << 1), cmd),
+                                     value & 0xff), value >> 8);
+}
+
+/** PEC of a MLX90615 command frame without data (address, command) */
+constexpr uint8_t mlx90615CommandPec(uint8_t addr, uint8_t cmd) {
+    return mlx90615Crc8(mlx90615Crc8(0, addr << 1), cmd);
+}
+
+static_assert(mlx90615Crc8(0, 0x01) == 0x07, "CRC-8 polynomial");
+static_assert(mlx90615Crc8(0, 0xff) == 0xf3, "CRC-8 polynomial");
+
+/** Bit by bit CRC-8 over a buffer */
+inline uint8_t mlx90615Crc8Bitwise(uint8_t crc, const uint8_t* data, int size) {
+    while (size--) {
+        crc ^= *data++;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ MLX90615_PEC_POLY : crc << 1;
+        }
+    }
+    return crc;
+}
+
+/** CRC-8 over a buffer, one nibble at a time */
+inline uint8_t mlx90615Crc8Nibble(uint8_t crc, const uint8_t* data, int size) {
+    static const uint8_t table[16] PROGMEM = {
+        mlx90615Crc8Shift(0x00, 4), mlx90615Crc8Shift(0x10, 4), mlx90615Crc8Shift(0x20, 4), mlx90615Crc8Shift(0x30, 4),
+        mlx90615Crc8Shift(0x40, 4), mlx90615Crc8Shift(0x50, 4), mlx90615Crc8Shift(0x60, 4), mlx90615Crc8Shift(0x70, 4),
+        mlx90615Crc8Shift(0x80, 4), mlx90615Crc8Shift(0x90, 4), mlx90615Crc8Shift(0xa0, 4), mlx90615Crc8Shift(0xb0, 4),
+        mlx90615Crc8Shift(0xc0, 4), mlx90615Crc8Shift(0xd0, 4), mlx90615Crc8Shift(0xe0, 4), mlx90615Crc8Shift(0xf0, 4)
+    };
+    while (size--) {
+        crc ^= *data++;
+        crc = (crc << 4) ^ pgm_read_byte(&table[crc >> 4]);
+        crc = (crc << 4) ^ pgm_read_byte(&table[crc >> 4]);
+    }
+    return crc;
+}
+
+// Table rows, generated by the compiler from mlx90615Crc8Shift
+#define MLX90615_CRC8_GEN_4(i)      mlx90615Crc8Shift(i, 8), mlx90615Crc8Shift(i + 1, 8), \
+                                    mlx90615Crc8Shift(i + 2, 8), mlx90615Crc8Shift(i + 3, 8)
+#define MLX90615_CRC8_GEN_16(i)     MLX90615_CRC8_GEN_4(i), MLX90615_CRC8_GEN_4(i + 4), \
+                                    MLX90615_CRC8_GEN_4(i + 8), MLX90615_CRC8_GEN_4(i + 12)
+#define MLX90615_CRC8_GEN_64(i)     MLX90615_CRC8_GEN_16(i), MLX90615_CRC8_GEN_16(i + 16), \
+                                    MLX90615_CRC8_GEN_16(i + 32), MLX90615_CRC8_GEN_16(i + 48)
+
+/** CRC-8 over a buffer, one byte at a time */
+inline uint8_t mlx90615Crc8Table(uint8_t crc, const uint8_t* data, int size) {
+    static const uint8_t table[256] PROGMEM = {
+        MLX90615_CRC8_GEN_64(0x00), MLX90615_CRC8_GEN_64(0x40),
+        MLX90615_CRC8_GEN_64(0x80), MLX90615_CRC8_GEN_64(0xc0)
+    };
+    while (size--) {
+        crc = pgm_read_byte(&table[crc ^ *data++]);
+    }
+    return crc;
+}
+
+#undef MLX90615_CRC8_GEN_4
+#undef MLX90615_CRC8_GEN_16
+#undef MLX90615_CRC8_GEN_64
+
+/** CRC-8 over a buffer with the implementation selected by MLX90615_CRC8_IMPL */
+inline uint8_t mlx90615Crc8(uint8_t crc, const uint8_t* data, int size) {
+    #if MLX90615_CRC8_IMPL == MLX90615_CRC8_TABLE
+    return mlx90615Crc8Table(crc, data, size);
+    #elif MLX90615_CRC8_IMPL == MLX90615_CRC8_NIBBLE
+    return mlx90615Crc8Nibble(crc, data, size);
+    #else
+    return mlx90615Crc8Bitwise(crc, data, size);
+    #endif
+}
+
+#endif // __MLX90615_CRC_H__
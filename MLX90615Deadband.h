@@ -0,0 +1,129 @@
+#ifndef __MLX90615_DEADBAND_H__
+#define __MLX90615_DEADBAND_H__
+
+#include <Arduino.h>
+#include <MLX90615.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Events returned by MLX90615Deadband::update() and poll()
+#define MLX90615_EVENT_OBJECT       0x01    // Object moved out of the deadband
+#define MLX90615_EVENT_AMBIENT      0x02    // Ambient moved out of the deadband
+#define MLX90615_EVENT_HEARTBEAT    0x04    // Nothing changed for the max silence
+
+// 1 LSB of the temperature registers is 0.02 K
+#define MLX90615_DEADBAND_DEFAULT   5       // 0.1 K
+#define MLX90615_HEARTBEAT_DEFAULT  60000   // ms
+
+/**
+    Change detection for one MLX90615: samples are compared, in raw LSBs,
+    against the last reported ones, and an event is only raised when the
+    object or ambient temperature moved by at least the deadband. As the
+    reference is the last reported value and not the last sample, noise
+    around a threshold does not toggle reports (hysteresis), and slow
+    drifts are still reported once they add up to the deadband. A
+    heartbeat event is raised after maxSilence ms without any report.
+*/
+class MLX90615Deadband {
+
+  protected:
+    MLX90615* device;
+    uint16_t objectBand;
+    uint16_t ambientBand;
+    uint32_t maxSilence;
+    uint32_t lastReport;
+    bool primed;
+    MLX90615Data last;      // Last reported sample
+
+    static bool outside(uint16_t value, uint16_t reference, uint16_t band) {
+        return value >= reference ? value - reference >= band : reference - value >= band;
+    }
+
+  public:
+
+    /**
+        @param mlx: Device read by poll(), may be 0 when only update() is used
+        @param band: Deadband in LSB (0.02 K) for object and ambient
+        @param silence: Max time without a report in ms, 0 to disable the heartbeat
+    */
+    MLX90615Deadband(MLX90615* mlx, uint16_t band = MLX90615_DEADBAND_DEFAULT,
+                     uint32_t silence = MLX90615_HEARTBEAT_DEFAULT) {
+        device = mlx;
+        objectBand = band;
+        ambientBand = band;
+        maxSilence = silence;
+        lastReport = 0;
+        primed = false;
+        last.rawIr = 0;
+        last.ambient = 0;
+        last.object = 0;
+    }
+
+    /** Deadbands in LSB (0.02 K), set separately for object and ambient */
+    void setDeadband(uint16_t object, uint16_t ambient) {
+        objectBand = object;
+        ambientBand = ambient;
+    }
+
+    /** Max time without a report in ms, 0 to disable the heartbeat */
+    void setHeartbeat(uint32_t silence) {
+        maxSilence = silence;
+    }
+
+    /** Report the next sample whatever its value */
+    void reset() {
+        primed = false;
+    }
+
+    /**
+        Compare a sample with the last reported one
+        @param data: Sample, as filled by readAll()
+        @param now: Time in ms (millis())
+        @return: events (MLX90615_EVENT_*), 0 when nothing is to be reported.
+                 The first sample reports object and ambient.
+    */
+    uint8_t update(const MLX90615Data* data, uint32_t now) {
+        uint8_t events = 0;
+        if (!primed) {
+            events = MLX90615_EVENT_OBJECT | MLX90615_EVENT_AMBIENT;
+            primed = true;
+        } else {
+            if (outside(data->object, last.object, objectBand)) {
+                events |= MLX90615_EVENT_OBJECT;
+            }
+            if (outside(data->ambient, last.ambient, ambientBand)) {
+                events |= MLX90615_EVENT_AMBIENT;
+            }
+            if (!events && maxSilence && now - lastReport >= maxSilence) {
+                events = MLX90615_EVENT_HEARTBEAT;
+            }
+        }
+        if (events) {
+            last = *data;
+            lastReport = now;
+        }
+        return events;
+    }
+
+    /**
+        Read the device and compare the sample with the last reported one
+        @param data: Pointer to the sample read, valid if status is 0
+        @return: events (>= 0, see update()) or status: -1  Bad CRC calc
+                                                       -2  I2C Error
+                                                       -10 No connector
+    */
+    int poll(MLX90615Data* data) {
+        int status = device ? device->readAll(data) : -10;
+        if (status) {
+            return status;
+        }
+        return update(data, millis());
+    }
+
+    /** Last reported sample */
+    const MLX90615Data& reported() {
+        return last;
+    }
+};
+
+#endif // __MLX90615_DEADBAND_H__
@@ -0,0 +1,350 @@
+#ifndef __MLX90615_EEPROM_H__
+#define __MLX90615_EEPROM_H__
+
+#include <Arduino.h>
+#include <MLX90615.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Erase or write time of one EEPROM cell
+#ifndef MLX90615_EEPROM_WRITE_MS
+    #define MLX90615_EEPROM_WRITE_MS    10
+#endif
+
+#define MLX90615_EEPROM_CELLS       4   // 0x10 .. 0x13
+
+// MLX90615Eeprom::phase()
+#define MLX90615_EEPROM_IDLE        0
+#define MLX90615_EEPROM_ERASE       1
+#define MLX90615_EEPROM_ERASE_WAIT  2
+#define MLX90615_EEPROM_WRITE       3
+#define MLX90615_EEPROM_WRITE_WAIT  4
+#define MLX90615_EEPROM_VERIFY      5
+
+/**
+    EEPROM manager for the writable cells 0x10..0x13 of one MLX90615.
+
+    Keeps a RAM shadow of the cells, read once by load(). set() only
+    queues a write when the value differs from the shadow, and poll()
+    runs erase, wait, write, wait, read back and compare for each queued
+    cell without ever blocking. The wait is skipped for the erase of a
+    cell that is already 0x0000. A write that fails once its cell is
+    erased leaves the cell queued, so the next poll() writes it again
+    rather than leaving 0x0000 in it (for MLX90615_EEPROM_SA, address
+    0x00 after the next power cycle).
+
+    Note: a new slave address (MLX90615_EEPROM_SA) is only used by the
+    device after a power cycle.
+*/
+class MLX90615Eeprom {
+
+  protected:
+    MLX90615* device;
+    uint16_t shadow[MLX90615_EEPROM_CELLS];
+    uint16_t target[MLX90615_EEPROM_CELLS];
+    uint8_t loaded;         // Cells with a valid shadow
+    uint8_t dirty;          // Cells queued for writing
+    uint8_t cell;           // Cell in progress
+    uint8_t current;        // Phase of the cell in progress
+    uint16_t writing;       // Value being written to cell
+    uint32_t since;         // Start of the current wait
+    uint32_t writes;
+    uint32_t skipped;
+    uint32_t (*clock)(void);
+
+    static uint32_t defaultClock(void) {
+        return micros();
+    }
+
+    static bool valid(uint8_t reg) {
+        return reg >= MLX90615_EEPROM_SA && reg < MLX90615_EEPROM_SA + MLX90615_EEPROM_CELLS;
+    }
+
+    int finish(int status) {
+        // Set again while it was being written: keep it queued
+        if (status || target[cell] == shadow[cell]) {
+            dirty &= ~(1 << cell);
+        }
+        current = MLX90615_EEPROM_IDLE;
+        return status ? status : (dirty ? 1 : 0);
+    }
+
+  public:
+
+    explicit MLX90615Eeprom(MLX90615* mlx) {
+        device = mlx;
+        loaded = 0;
+        dirty = 0;
+        cell = MLX90615_EEPROM_CELLS - 1;   // First poll() starts at cell 0
+        current = MLX90615_EEPROM_IDLE;
+        writing = 0;
+        since = 0;
+        writes = 0;
+        skipped = 0;
+        clock = defaultClock;
+    }
+
+    /** Replace micros() as time base (e.g. a simulated bus clock) */
+    void setClock(uint32_t (*us)(void)) {
+        clock = us;
+    }
+
+    MLX90615* getDevice() {
+        return device;
+    }
+
+    /**
+        Read the 4 cells into the shadow
+        @return: status, as readReg()
+    */
+    int load() {
+        int status = 0;
+        for (uint8_t i = 0; i < MLX90615_EEPROM_CELLS; i++) {
+            int s = device->readReg(MLX90615_EEPROM_SA + i, &shadow[i]);
+            if (s) {
+                status = s;
+            } else {
+                loaded |= 1 << i;
+            }
+        }
+        return status;
+    }
+
+    /**
+        Cell value from the shadow, no bus access
+        @return: status:   0  OK
+                         -3  Not a writable EEPROM cell, or not loaded
+    */
+    int get(uint8_t reg, uint16_t* value) {
+        if (!valid(reg) || !(loaded & (1 << (reg - MLX90615_EEPROM_SA)))) {
+            return -3;
+        }
+        *value = shadow[reg - MLX90615_EEPROM_SA];
+        return 0;
+    }
+
+    /**
+        Queue a cell write; written by poll()
+        @return: status:   1  Queued
+                          0  Unchanged, nothing to write
+                         -3  Not a writable EEPROM cell, or not loaded
+    */
+    int set(uint8_t reg, uint16_t value) {
+        if (!valid(reg) || !(loaded & (1 << (reg - MLX90615_EEPROM_SA)))) {
+            return -3;
+        }
+        uint8_t i = reg - MLX90615_EEPROM_SA;
+        target[i] = value;
+        if (i == cell && current != MLX90615_EEPROM_IDLE) {
+            // Being written: finish() requeues it if needed
+            return 1;
+        }
+        if (value == shadow[i]) {
+            if (dirty & (1 << i)) {
+                dirty &= ~(1 << i);
+            } else {
+                skipped++;
+            }
+            return 0;
+        }
+        dirty |= 1 << i;
+        return 1;
+    }
+
+    /**
+        Queue a write of some bits of a cell, keeping the others
+        @param mask: bits to change
+        @return: as set()
+    */
+    int setBits(uint8_t reg, uint16_t mask, uint16_t value) {
+        uint16_t old;
+        if (get(reg, &old)) {
+            return -3;
+        }
+        uint8_t i = reg - MLX90615_EEPROM_SA;
+        if (dirty & (1 << i)) {
+            old = target[i];
+        }
+        return set(reg, (old & ~mask) | (value & mask));
+    }
+
+    /**
+        Advance the queued writes by at most one bus operation. Never waits.
+        @return: status:   1  Writes in progress
+                          0  All writes done and verified
+                         -1  Bad CRC calc
+                         -2  I2C Error
+                         -5  Read back differs from the value written
+                         -7  Cell erased, but its write failed: still
+                             queued, written again by the next calls
+                Other errors are returned once, for the cell that failed
+                (its shadow then holds the value read back, if any); the
+                other cells go on with the next calls.
+    */
+    int poll() {
+        uint32_t now = clock();
+        uint16_t value;
+        int status;
+        switch (current) {
+            case MLX90615_EEPROM_IDLE:
+                if (!dirty) {
+                    return 0;
+                }
+                // Round robin, so a cell that keeps failing does not block the others
+                do {
+                    cell = (cell + 1) % MLX90615_EEPROM_CELLS;
+                } while (!(dirty & (1 << cell)));
+                writing = target[cell];
+                current = MLX90615_EEPROM_ERASE;
+                // fall through
+            case MLX90615_EEPROM_ERASE:
+                if (shadow[cell] == 0x0000) {
+                    current = writing ? MLX90615_EEPROM_WRITE : MLX90615_EEPROM_VERIFY;
+                    return 1;
+                }
+                status = device->writeReg(MLX90615_EEPROM_SA + cell, 0x0000);
+                if (status) {
+                    return finish(status);
+                }
+                shadow[cell] = 0x0000;
+                since = now;
+                current = MLX90615_EEPROM_ERASE_WAIT;
+                return 1;
+            case MLX90615_EEPROM_ERASE_WAIT:
+            case MLX90615_EEPROM_WRITE_WAIT:
+                if (now - since < MLX90615_EEPROM_WRITE_MS * 1000UL) {
+                    return 1;
+                }
+                current = current == MLX90615_EEPROM_ERASE_WAIT && writing ?
+                          MLX90615_EEPROM_WRITE : MLX90615_EEPROM_VERIFY;
+                return 1;
+            case MLX90615_EEPROM_WRITE:
+                status = device->writeReg(MLX90615_EEPROM_SA + cell, writing);
+                if (status) {
+                    // Erased, not written: keep it queued
+                    current = MLX90615_EEPROM_IDLE;
+                    return -7;
+                }
+                writes++;
+                since = now;
+                current = MLX90615_EEPROM_WRITE_WAIT;
+                return 1;
+            default:
+                status = device->readReg(MLX90615_EEPROM_SA + cell, &value);
+                if (status) {
+                    return finish(status);
+                }
+                shadow[cell] = value;
+                return finish(value == writing ? 0 : -5);
+        }
+    }
+
+    /**
+        Run the queued writes to completion, blocking
+        @return: as poll(), except 1, for the last error if any. Stops at
+                 -7, with the cell still queued: call again to retry.
+    */
+    int commit() {
+        int status;
+        int result = 0;
+        while ((status = poll()) != 0) {
+            if (status < 0) {
+                result = status;
+            }
+            if (status == -7) {
+                break;
+            }
+        }
+        return result;
+    }
+
+    /** True while writes are queued or in progress */
+    bool busy() {
+        return dirty != 0;
+    }
+
+    /** MLX90615_EEPROM_IDLE ... MLX90615_EEPROM_VERIFY */
+    uint8_t phase() {
+        return current;
+    }
+
+    /** Cell writes done since construction */
+    uint32_t getWrites() {
+        return writes;
+    }
+
+    /** set() calls skipped because the value was already there */
+    uint32_t getSkipped() {
+        return skipped;
+    }
+};
+
+/**
+    Overlapped EEPROM updates on several devices: each poll() gives every
+    busy device its next step, so all devices erase and write in the same
+    wait instead of one after the other.
+*/
+template <uint8_t N>
+class MLX90615EepromBatch {
+
+  protected:
+    MLX90615Eeprom* managers[N];
+    uint8_t count;
+
+  public:
+
+    MLX90615EepromBatch() {
+        count = 0;
+    }
+
+    /**
+        Add a device manager
+        @return: index, or -1 when the batch is full
+    */
+    int add(MLX90615Eeprom* manager) {
+        if (count >= N) {
+            return -1;
+        }
+        managers[count] = manager;
+        return count++;
+    }
+
+    /**
+        Step every busy device
+        @return: 1 while any device is busy, 0 when all are done, or the
+                 status (< 0) of a device that failed in this call
+    */
+    int poll() {
+        int result = 0;
+        bool busy = false;
+        for (uint8_t i = 0; i < count; i++) {
+            int status = managers[i]->poll();
+            if (status < 0) {
+                result = status;
+            }
+            busy |= managers[i]->busy();
+        }
+        return result ? result : (busy ? 1 : 0);
+    }
+
+    /**
+        Run all queued writes to completion, blocking
+        @return: 0 if all verified, else the last error. Stops at -7, as
+                 MLX90615Eeprom::commit()
+    */
+    int commit() {
+        int status;
+        int result = 0;
+        while ((status = poll()) != 0) {
+            if (status < 0) {
+                result = status;
+            }
+            if (status == -7) {
+                break;
+            }
+        }
+        return result;
+    }
+};
+
+#endif // __MLX90615_EEPROM_H__
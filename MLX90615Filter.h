@@ -0,0 +1,204 @@
+#ifndef __MLX90615_FILTER_H__
+#define __MLX90615_FILTER_H__
+
+#include <Arduino.h>
+#include <MLX90615.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+    Incremental filters over raw 16-bit register values (readReg, readAll),
+    one instance per channel, state allocated statically by the template.
+    Conversion to temperature is done once, on output:
+
+        uint16_t raw;
+        if (mlx90615.readReg(MLX90615_OBJECT_TEMPERATURE, &raw) == 0) {
+            filter.update(raw);
+        }
+        int32_t centi = filter.temperature<MLX90615_CENTI_CELSIUS>();
+
+    Only feed samples read with status 0. Filters can be chained, e.g. a
+    median for spike rejection in front of an EMA:
+        ema.update(median.update(raw));
+
+    RAM per channel (AVR, sizeof):
+    > MLX90615MovingAverage<N>: 2 * N + 6 bytes
+    > MLX90615Ema<SHIFT>:       5 bytes
+    > MLX90615Median<N>:        4 * N + 2 bytes
+    The "benchmark" example prints sizes and time per update().
+*/
+
+/**
+    Base of the filters: temperature of the filtered raw value
+*/
+template <class Filter>
+class MLX90615FilterOutput {
+
+  public:
+
+    /**
+        Filtered value converted to temperature
+        @param unit: MLX90615_CENTI_CELSIUS, MLX90615_CENTI_FAHRENHEIT or MLX90615_KELVIN_X50
+    */
+    template <uint8_t unit>
+    int32_t temperature() {
+        return MLX90615::rawToInt<unit>(static_cast<Filter*>(this)->value());
+    }
+};
+
+/**
+    Moving average over the last N samples, O(1) per update with a
+    running sum. Until N samples were seen, averages the ones available.
+*/
+template <uint8_t N>
+class MLX90615MovingAverage : public MLX90615FilterOutput<MLX90615MovingAverage<N> > {
+
+    static_assert(N > 0, "N must be at least 1");
+
+  protected:
+    uint16_t window[N];
+    uint32_t sum;
+    uint8_t index;
+    uint8_t fill;
+
+  public:
+
+    MLX90615MovingAverage() {
+        reset();
+    }
+
+    void reset() {
+        sum = 0;
+        index = 0;
+        fill = 0;
+    }
+
+    /**
+        Add a raw sample
+        @return: average of the window, rounded
+    */
+    uint16_t update(uint16_t raw) {
+        if (fill < N) {
+            fill++;
+        } else {
+            sum -= window[index];
+        }
+        window[index] = raw;
+        sum += raw;
+        index = index + 1 < N ? index + 1 : 0;
+        return value();
+    }
+
+    uint16_t value() {
+        return fill ? (sum + fill / 2) / fill : 0;
+    }
+};
+
+/**
+    Exponential moving average with coefficient 1 / 2^SHIFT:
+    y += (x - y) / 2^SHIFT, in shifts and adds only. Time constant is
+    about 2^SHIFT samples. The first sample initializes the output.
+*/
+template <uint8_t SHIFT>
+class MLX90615Ema : public MLX90615FilterOutput<MLX90615Ema<SHIFT> > {
+
+    static_assert(SHIFT < 16, "SHIFT must be less than 16");
+
+  protected:
+    uint32_t acc;       // Output scaled by 2^SHIFT
+    bool primed;
+
+  public:
+
+    MLX90615Ema() {
+        reset();
+    }
+
+    void reset() {
+        acc = 0;
+        primed = false;
+    }
+
+    /**
+        Add a raw sample
+        @return: filtered value, rounded
+    */
+    uint16_t update(uint16_t raw) {
+        if (!primed) {
+            acc = (uint32_t)raw << SHIFT;
+            primed = true;
+        } else {
+            acc = acc - (acc >> SHIFT) + raw;
+        }
+        return value();
+    }
+
+    uint16_t value() {
+        return (acc + ((1UL << SHIFT) >> 1)) >> SHIFT;
+    }
+};
+
+/**
+    Running median of the last N samples, to reject single sample spikes
+    (a spike shorter than N / 2 + 1 samples never reaches the output).
+    Keeps the window sorted: O(N) per update, for small odd N (3..15).
+*/
+template <uint8_t N>
+class MLX90615Median : public MLX90615FilterOutput<MLX90615Median<N> > {
+
+    static_assert(N & 1, "N must be odd");
+
+  protected:
+    uint16_t window[N];     // Arrival order
+    uint16_t sorted[N];
+    uint8_t index;
+    uint8_t fill;
+
+  public:
+
+    MLX90615Median() {
+        reset();
+    }
+
+    void reset() {
+        index = 0;
+        fill = 0;
+    }
+
+    /**
+        Add a raw sample
+        @return: median of the window
+    */
+    uint16_t update(uint16_t raw) {
+        uint8_t pos = fill;
+        if (fill < N) {
+            fill++;
+        } else {
+            // Drop the oldest sample from the sorted copy
+            uint16_t old = window[index];
+            pos = 0;
+            while (sorted[pos] != old) {
+                pos++;
+            }
+        }
+        // Move the hole left or right to where raw belongs
+        while (pos > 0 && sorted[pos - 1] > raw) {
+            sorted[pos] = sorted[pos - 1];
+            pos--;
+        }
+        while (pos + 1 < fill && sorted[pos + 1] < raw) {
+            sorted[pos] = sorted[pos + 1];
+            pos++;
+        }
+        sorted[pos] = raw;
+        window[index] = raw;
+        index = index + 1 < N ? index + 1 : 0;
+        return value();
+    }
+
+    uint16_t value() {
+        return fill ? sorted[(fill - 1) / 2] : 0;
+    }
+};
+
+#endif // __MLX90615_FILTER_H__
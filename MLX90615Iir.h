@@ -0,0 +1,109 @@
+#ifndef __MLX90615_IIR_H__
+#define __MLX90615_IIR_H__
+
+#include <Arduino.h>
+#include <MLX90615.h>
+#include <MLX90615Eeprom.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+    On-chip IIR filter of the object temperature, bits 14..12 of CONFIG.
+
+    Setting n (1 .. 7) weights each new conversion by 1/n:
+        out += (in - out) / n
+    so a step settles to 1% in settlingConversions(n) conversions, and
+    white noise drops to 1 / sqrt(2n - 1) of its unfiltered rms. Setting 0
+    is reserved. 1 is no filtering: fastest, noisiest.
+*/
+
+#define MLX90615_CONFIG_IIR_MASK    0x7000
+#define MLX90615_CONFIG_IIR_SHIFT   12
+#define MLX90615_IIR_MAX            7
+
+/**
+    Typed access to the IIR setting of one device, on the shadow of a
+    loaded MLX90615Eeprom; setIir() only queues the write (see
+    MLX90615Eeprom::set()), commit() or poll() the manager to write it.
+*/
+class MLX90615Iir {
+
+  protected:
+    MLX90615Eeprom* eeprom;
+
+  public:
+
+    explicit MLX90615Iir(MLX90615Eeprom* manager) {
+        eeprom = manager;
+    }
+
+    /**
+        IIR setting from the shadow
+        @param setting: Pointer to store the setting, 1 .. MLX90615_IIR_MAX
+        @return: status:   0  OK
+                         -3  CONFIG not loaded
+    */
+    int getIir(uint8_t* setting) {
+        uint16_t config;
+        if (eeprom->get(MLX90615_EEPROM_CONFIG, &config)) {
+            return -3;
+        }
+        *setting = (config & MLX90615_CONFIG_IIR_MASK) >> MLX90615_CONFIG_IIR_SHIFT;
+        return 0;
+    }
+
+    /**
+        Queue an IIR setting, keeping the other CONFIG bits
+        @param setting: 1 (no filtering) .. MLX90615_IIR_MAX (most filtering)
+        @return: as MLX90615Eeprom::set(), -3 also for a setting out of range
+    */
+    int setIir(uint8_t setting) {
+        if (setting < 1 || setting > MLX90615_IIR_MAX) {
+            return -3;
+        }
+        return eeprom->setBits(MLX90615_EEPROM_CONFIG, MLX90615_CONFIG_IIR_MASK,
+                               (uint16_t)setting << MLX90615_CONFIG_IIR_SHIFT);
+    }
+
+    /**
+        Conversions for a step to settle within 1%
+        @return: 0 for an invalid setting
+    */
+    static uint8_t settlingConversions(uint8_t setting) {
+        // ceil(ln(0.01) / ln(1 - 1/n))
+        static const uint8_t conversions[MLX90615_IIR_MAX + 1] = {0, 1, 7, 12, 17, 21, 26, 30};
+        return setting <= MLX90615_IIR_MAX ? conversions[setting] : 0;
+    }
+
+    /** Step response time to 1%, in ms, see MLX90615_CONVERSION_MS */
+    static uint16_t settlingMs(uint8_t setting) {
+        return settlingConversions(setting) * MLX90615_CONVERSION_MS;
+    }
+
+    /**
+        Filtered noise, from the unfiltered one
+        @param rms: Unfiltered rms noise, any unit
+        @return: rms noise at the output of the filter, same unit
+    */
+    static float noise(uint8_t setting, float rms) {
+        return setting ? rms / sqrt(2 * setting - 1) : rms;
+    }
+
+    /**
+        Fastest setting meeting a noise budget
+        @param rms: Unfiltered rms noise, e.g. measured with setting 1
+        @param budget: Highest acceptable rms noise, same unit
+        @return: setting, or MLX90615_IIR_MAX if even that is too noisy
+    */
+    static uint8_t pick(float rms, float budget) {
+        // rms^2 / (2n - 1) <= budget^2
+        for (uint8_t setting = 1; setting < MLX90615_IIR_MAX; setting++) {
+            if (rms * rms <= budget * budget * (2 * setting - 1)) {
+                return setting;
+            }
+        }
+        return MLX90615_IIR_MAX;
+    }
+};
+
+#endif // __MLX90615_IIR_H__
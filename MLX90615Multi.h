@@ -0,0 +1,79 @@
+#ifndef __MLX90615_MULTI_H__
+#define __MLX90615_MULTI_H__
+
+#include <Arduino.h>
+#include <I2cMaster.h>
+#include <MLX90615.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+    One MLX90615 per bus of a SoftI2cMultiMaster, all at the same address,
+    read in lockstep: a single pass over the buses returns one reading per
+    sensor, so the time per reading drops by the number of buses.
+*/
+class MLX90615Multi {
+
+  protected:
+    SoftI2cMultiMaster* bus;
+    uint8_t dev;
+
+  public:
+
+    MLX90615Multi(uint8_t addr, SoftI2cMultiMaster* i2c) {
+        dev = addr << 1;
+        bus = i2c;
+    }
+
+    /**
+        Read the same register from every sensor.
+        @param MLXaddr: MLX90615 EEPROM/RAM address
+        @param results: One value per bus (bus->count() entries)
+        @return: Mask of the buses with a valid reading (Ack and PEC ok);
+                 results of the other buses are left untouched
+    */
+    uint8_t readReg(uint8_t MLXaddr, uint16_t* results) {
+        uint8_t lsb[I2C_MULTI_MAX_BUSES];
+        uint8_t msb[I2C_MULTI_MAX_BUSES];
+        uint8_t pec[I2C_MULTI_MAX_BUSES];
+
+        uint8_t ok = bus->start(dev | I2C_WRITE);
+        ok &= bus->write(MLXaddr);
+        ok &= bus->restart(dev | I2C_READ);
+        bus->read(false, lsb);
+        bus->read(false, msb);
+        bus->read(true, pec);
+        bus->stop();
+
+        for (uint8_t i = 0; i < bus->count(); i++) {
+            if (!(ok & (1 << i))) {
+                continue;
+            }
+            if (!MLX90615::checkPec(dev, MLXaddr, lsb[i], msb[i], pec[i])) {
+                ok &= ~(1 << i);
+                continue;
+            }
+            results[i] = (uint16_t)msb[i] << 8 | lsb[i];
+        }
+        return ok;
+    }
+
+    /**
+        Temperature of every sensor, in an integer unit (see MLX90615::rawToInt)
+        @return: Mask of the buses with a valid reading
+    */
+    template <uint8_t unit>
+    uint8_t getTemperatureInt(int Temperature_kind, int32_t* values) {
+        uint16_t raw[I2C_MULTI_MAX_BUSES];
+
+        uint8_t ok = readReg(Temperature_kind, raw);
+        for (uint8_t i = 0; i < bus->count(); i++) {
+            if (ok & (1 << i)) {
+                values[i] = MLX90615::rawToInt<unit>(raw[i]);
+            }
+        }
+        return ok;
+    }
+};
+
+#endif // __MLX90615_MULTI_H__
@@ -0,0 +1,295 @@
+#ifndef __MLX90615_OUTPUT_H__
+#define __MLX90615_OUTPUT_H__
+
+#include <Arduino.h>
+#include <MLX90615.h>
+#include <MLX90615Eeprom.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+    PWM and thermal relay output of the MLX90615 (on the SDA pin).
+
+    In PWM mode the duty cycle follows the object (or ambient)
+    temperature between PWMT_MIN and PWMT_MIN + PWMT_RNG; in thermal relay
+    mode the pin goes high above PWMT_MIN and low again PWMT_RNG below it.
+    Either way a pin interrupt gets the temperature, or the alarm, with no
+    bus traffic at all.
+
+    The output settings are EEPROM cells, written through MLX90615Eeprom
+    (safe erase/write/verify) and used from the next power cycle. A device
+    in PWM or relay mode switches back to SMBus for the rest of the power
+    cycle when SCL is held low for a few ms (MLX90615T::wake() does it).
+*/
+
+// MLX90615_EEPROM_CONFIG bits
+#define MLX90615_CONFIG_SMBUS       0x0001  // SMBus, else PWM/thermal relay output
+#define MLX90615_CONFIG_PWM_SLOW    0x0002  // Low PWM frequency
+#define MLX90615_CONFIG_RELAY       0x0004  // Thermal relay instead of PWM
+#define MLX90615_CONFIG_OBJECT      0x0008  // Output follows To, else Ta
+
+// MLX90615Output::getMode()/setMode()
+#define MLX90615_MODE_SMBUS         0
+#define MLX90615_MODE_PWM           1
+#define MLX90615_MODE_RELAY         2
+
+// PWMT_MIN shares its low bits with the slave address: the scale moves by this step
+#define MLX90615_PWMT_MIN_STEP      0x80
+
+/**
+    Typed access to the output cells (PWMT_MIN, PWMT_RNG, CONFIG) of one
+    device, on the shadow of a loaded MLX90615Eeprom. The setters only
+    queue the writes (see MLX90615Eeprom::set()); commit() or poll() the
+    manager to write them.
+
+    PWMT_MIN is the slave address cell: its low 7 bits stay the address,
+    so the minimum of the scale is rounded down to a MLX90615_PWMT_MIN_STEP
+    multiple (2.56 K), and the range grows to keep the maximum.
+*/
+class MLX90615Output {
+
+  protected:
+    MLX90615Eeprom* eeprom;
+
+    int setCells(uint16_t min, uint16_t range) {
+        int status = eeprom->setBits(MLX90615_EEPROM_PWMT_MIN, ~(MLX90615_PWMT_MIN_STEP - 1), min);
+        if (status < 0) {
+            return status;
+        }
+        int other = eeprom->set(MLX90615_EEPROM_PWMT_RNG, range);
+        return other < 0 ? other : (status || other ? 1 : 0);
+    }
+
+  public:
+
+    explicit MLX90615Output(MLX90615Eeprom* manager) {
+        eeprom = manager;
+    }
+
+    /**
+        Output mode from the shadow
+        @param mode: Pointer to store MLX90615_MODE_SMBUS, _PWM or _RELAY
+        @return: status:   0  OK
+                         -3  CONFIG not loaded
+    */
+    int getMode(uint8_t* mode) {
+        uint16_t config;
+        if (eeprom->get(MLX90615_EEPROM_CONFIG, &config)) {
+            return -3;
+        }
+        *mode = config & MLX90615_CONFIG_SMBUS ? MLX90615_MODE_SMBUS :
+                config & MLX90615_CONFIG_RELAY ? MLX90615_MODE_RELAY : MLX90615_MODE_PWM;
+        return 0;
+    }
+
+    /**
+        Queue an output mode change
+        @param mode: MLX90615_MODE_SMBUS, MLX90615_MODE_PWM or MLX90615_MODE_RELAY
+        @return: as MLX90615Eeprom::set(), -3 also for an unknown mode
+    */
+    int setMode(uint8_t mode) {
+        if (mode > MLX90615_MODE_RELAY) {
+            return -3;
+        }
+        if (mode == MLX90615_MODE_SMBUS) {
+            return eeprom->setBits(MLX90615_EEPROM_CONFIG, MLX90615_CONFIG_SMBUS, MLX90615_CONFIG_SMBUS);
+        }
+        return eeprom->setBits(MLX90615_EEPROM_CONFIG, MLX90615_CONFIG_SMBUS | MLX90615_CONFIG_RELAY,
+                               mode == MLX90615_MODE_RELAY ? MLX90615_CONFIG_RELAY : 0);
+    }
+
+    /**
+        Queue the PWM settings
+        @param object: Output the object temperature, else the ambient one
+        @param slow: Low PWM frequency (longer period, easier to time)
+        @return: as MLX90615Eeprom::set()
+    */
+    int setSource(bool object, bool slow = false) {
+        return eeprom->setBits(MLX90615_EEPROM_CONFIG, MLX90615_CONFIG_OBJECT | MLX90615_CONFIG_PWM_SLOW,
+                               (object ? MLX90615_CONFIG_OBJECT : 0) | (slow ? MLX90615_CONFIG_PWM_SLOW : 0));
+    }
+
+    /**
+        Queue a PWM scale from raw temperatures (0.02 K)
+        @param min: Temperature at 0% duty, rounded down (see above)
+        @param max: Temperature at 100% duty
+        @return: as MLX90615Eeprom::set(), -3 also for max <= min
+    */
+    int setRawScale(uint16_t min, uint16_t max) {
+        uint16_t sa;
+        if (eeprom->get(MLX90615_EEPROM_PWMT_MIN, &sa) || max <= min) {
+            return -3;
+        }
+        min &= ~(MLX90615_PWMT_MIN_STEP - 1);
+        return setCells(min, max - min);
+    }
+
+    /**
+        Queue a PWM scale
+        @param unit: MLX90615_CENTI_CELSIUS, MLX90615_CENTI_FAHRENHEIT or MLX90615_KELVIN_X50
+        @return: as setRawScale()
+    */
+    template <uint8_t unit>
+    int setScale(int32_t min, int32_t max) {
+        return setRawScale(MLX90615::intToRaw<unit>(min), MLX90615::intToRaw<unit>(max));
+    }
+
+    /**
+        Queue the thermal relay switching points: the pin goes high above
+        threshold (rounded down, see above) and low again below
+        threshold - hysteresis (not moved by the rounding; the hysteresis
+        shrinks to 0 when it is smaller than the rounding)
+        @param unit: As setScale(); hysteresis in the same unit
+        @return: as MLX90615Eeprom::set(), -3 also for cells not loaded
+    */
+    template <uint8_t unit>
+    int setRelay(int32_t threshold, int32_t hysteresis) {
+        uint16_t sa;
+        if (eeprom->get(MLX90615_EEPROM_PWMT_MIN, &sa) || hysteresis < 0) {
+            return -3;
+        }
+        uint16_t on = MLX90615::intToRaw<unit>(threshold) & ~(MLX90615_PWMT_MIN_STEP - 1);
+        uint16_t off = MLX90615::intToRaw<unit>(threshold - hysteresis);
+        // Range from the rounded threshold, so the pin still goes low at off
+        return setCells(on, on > off ? on - off : 0);
+    }
+
+    /**
+        Raw PWM scale from the shadow (also the relay threshold and hysteresis)
+        @return: status:   0  OK
+                         -3  Cells not loaded
+    */
+    int getRawScale(uint16_t* min, uint16_t* range) {
+        uint16_t sa;
+        if (eeprom->get(MLX90615_EEPROM_PWMT_MIN, &sa) || eeprom->get(MLX90615_EEPROM_PWMT_RNG, range)) {
+            return -3;
+        }
+        *min = sa & ~(MLX90615_PWMT_MIN_STEP - 1);
+        return 0;
+    }
+
+    /**
+        PWM scale from the shadow
+        @param unit: As setScale()
+        @return: as getRawScale()
+    */
+    template <uint8_t unit>
+    int getScale(int32_t* min, int32_t* max) {
+        uint16_t rawMin, range;
+        int status = getRawScale(&rawMin, &range);
+        if (!status) {
+            *min = MLX90615::rawToInt<unit>(rawMin);
+            *max = MLX90615::rawToInt<unit>(MLX90615::clampRaw((int32_t)rawMin + range));
+        }
+        return status;
+    }
+};
+
+/**
+    Temperature from the PWM output, timed by a pin interrupt: call edge()
+    from the interrupt (pin change or input capture) with the new pin
+    level and a timestamp, then read() from loop(). No bus traffic.
+
+    edge() only writes, read() only reads: read() takes a copy again when
+    an edge came in meanwhile, so interrupts are never disabled.
+*/
+class MLX90615PwmReader {
+
+  protected:
+    uint16_t min;               // Raw temperature at 0% duty
+    uint16_t range;             // Raw temperature span of 0% .. 100%
+    uint32_t timeout;           // Longest valid time without an edge, us
+    volatile uint32_t rise;     // Last rising edge
+    volatile uint32_t fall;     // Last falling edge
+    volatile uint32_t highTime; // High time of the last complete period
+    volatile uint32_t period;   // Last complete period, 0 = none yet
+    volatile uint8_t edges;     // Bumped after each update
+    volatile bool started;      // A rising edge was seen
+    volatile bool level;
+
+  public:
+
+    /**
+        @param rawMin, rawRange: PWM scale, see MLX90615Output::getRawScale()
+        @param timeoutUs: After this long without an edge, read() fails
+    */
+    MLX90615PwmReader(uint16_t rawMin, uint16_t rawRange, uint32_t timeoutUs = 250000UL) {
+        min = rawMin;
+        range = rawRange;
+        timeout = timeoutUs;
+        rise = 0;
+        fall = 0;
+        highTime = 0;
+        period = 0;
+        edges = 0;
+        started = false;
+        level = false;
+    }
+
+    /** Change the PWM scale, see MLX90615Output::getRawScale() */
+    void setScale(uint16_t rawMin, uint16_t rawRange) {
+        min = rawMin;
+        range = rawRange;
+    }
+
+    /** Interrupt side: the output changed to high (true) or low */
+    void edge(bool high, uint32_t now) {
+        if (high == level) {
+            return;
+        }
+        if (!high) {
+            fall = now;
+        } else {
+            if (started) {
+                highTime = fall - rise;
+                period = now - rise;
+            }
+            rise = now;
+            started = true;
+        }
+        level = high;
+        edges++;
+    }
+
+    /**
+        Temperature of the last complete PWM period
+        @param raw: Pointer to store the raw temperature (see MLX90615::rawToInt)
+        @param now: Current time, same clock as edge()
+        @return: status:   0  OK
+                         -3  No complete period yet, or no edge for too long
+    */
+    int read(uint16_t* raw, uint32_t now) {
+        uint8_t seen;
+        uint32_t h, p, t;
+        do {
+            seen = edges;
+            h = highTime;
+            p = period;
+            t = level ? rise : fall;
+        } while (seen != edges);
+        if (!p || now - t > timeout || h > p) {
+            return -3;
+        }
+        *raw = min + (uint16_t)(((uint64_t)h * range + p / 2) / p);
+        return 0;
+    }
+
+    /** Duty cycle of the last complete period, 0 .. 65535 */
+    uint16_t duty() {
+        uint8_t seen;
+        uint32_t h, p;
+        do {
+            seen = edges;
+            h = highTime;
+            p = period;
+        } while (seen != edges);
+        return p && h < p ? (uint16_t)(((uint64_t)h << 16) / p) : (p ? 0xFFFF : 0);
+    }
+
+    /** Current output level: the relay state in thermal relay mode */
+    bool state() {
+        return level;
+    }
+};
+
+#endif // __MLX90615_OUTPUT_H__
@@ -0,0 +1,190 @@
+#ifndef __MLX90615_POWER_H__
+#define __MLX90615_POWER_H__
+
+#include <Arduino.h>
+#include <MLX90615.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Readings discarded after settling, before the scheduled one
+#ifndef MLX90615_WAKE_SKIP
+    #define MLX90615_WAKE_SKIP          1
+#endif
+
+// MLX90615DutyCycle::state()
+#define MLX90615_POWER_AWAKE        0   // Waiting for the next read, awake
+#define MLX90615_POWER_ASLEEP       1
+#define MLX90615_POWER_WAKING       2   // SCL held low
+#define MLX90615_POWER_SETTLING     3   // Awake, data not valid yet
+
+/**
+    Duty-cycled sampling of one MLX90615: the device sleeps between reads
+    and is woken ahead of each scheduled read, so that the wake-up pulse,
+    the settling time and the discarded first readings
+    (MLX90615_WAKE_SKIP, one conversion apart) are over when the read is
+    due.
+
+    When the period is shorter than wake-up plus settling, the device is
+    just kept awake.
+
+    Call poll() from loop(); it never waits. Waking up pulls SCL low for
+    the whole bus: other devices on the bus wake up too, and the bus can't
+    be used during the pulse.
+*/
+class MLX90615DutyCycle {
+
+  protected:
+    MLX90615* device;
+    uint8_t current;
+    uint8_t skipLeft;
+    uint32_t period;        // us between reads
+    uint32_t due;           // Time of the next read
+    uint32_t since;         // Start of the current state
+    uint32_t started;
+    uint32_t awakeSince;
+    uint32_t awakeUs;       // Time awake before awakeSince
+    uint32_t lastLatency;
+    uint32_t maxLatency;
+    uint32_t (*clock)(void);
+
+    static uint32_t defaultClock(void) {
+        return micros();
+    }
+
+    // Wake-up ahead of the read: pulse, settling, and one conversion per skipped reading
+    static uint32_t lead() {
+        return (MLX90615_WAKE_PULSE_MS + MLX90615_WAKE_SETTLE_MS +
+                MLX90615_WAKE_SKIP * MLX90615_CONVERSION_MS) * 1000UL;
+    }
+
+  public:
+
+    /**
+        @param mlx: Device to sample
+        @param periodMs: Time between reads in ms
+    */
+    MLX90615DutyCycle(MLX90615* mlx, uint32_t periodMs) {
+        device = mlx;
+        period = periodMs * 1000UL;
+        clock = defaultClock;
+        begin();
+    }
+
+    /** Restart the schedule now, with the device awake; first read at once */
+    void begin() {
+        current = MLX90615_POWER_AWAKE;
+        skipLeft = 0;
+        started = clock();
+        due = started;
+        since = started;
+        awakeSince = started;
+        awakeUs = 0;
+        lastLatency = 0;
+        maxLatency = 0;
+    }
+
+    /** Replace micros() as time base (e.g. a simulated bus clock); restarts the schedule. */
+    void setClock(uint32_t (*us)(void)) {
+        clock = us;
+        begin();
+    }
+
+    /**
+        Advance the power state machine, and read if the read is due
+        @param data: Pointer to store the sample
+        @return: 1 new sample in data, 0 nothing yet, or the readAll() status
+                 (< 0) of a failed read
+    */
+    int poll(MLX90615Data* data) {
+        uint32_t now = clock();
+        switch (current) {
+            case MLX90615_POWER_ASLEEP:
+                if ((int32_t)(now - (due - lead())) < 0) {
+                    return 0;
+                }
+                device->beginWake();
+                current = MLX90615_POWER_WAKING;
+                since = now;
+                return 0;
+            case MLX90615_POWER_WAKING:
+                if (now - since < MLX90615_WAKE_PULSE_MS * 1000UL) {
+                    return 0;
+                }
+                device->endWake();
+                current = MLX90615_POWER_SETTLING;
+                since = now;
+                awakeSince = now;
+                skipLeft = MLX90615_WAKE_SKIP;
+                return 0;
+            case MLX90615_POWER_SETTLING:
+                if (now - since < MLX90615_WAKE_SETTLE_MS * 1000UL) {
+                    return 0;
+                }
+                current = MLX90615_POWER_AWAKE;
+                break;
+        }
+
+        if (skipLeft) {
+            // One conversion apart, the last one done before the read is due
+            if (now - since < MLX90615_CONVERSION_MS * 1000UL) {
+                return 0;
+            }
+            // Settling data: not for the caller, whose last sample stays
+            MLX90615Data skipped;
+            skipLeft--;
+            device->readAll(&skipped);
+            since = now;
+            return 0;
+        }
+        if ((int32_t)(now - due) < 0) {
+            return 0;
+        }
+        int status = device->readAll(data);
+        now = clock();
+        lastLatency = now - due;
+        if (lastLatency > maxLatency) {
+            maxLatency = lastLatency;
+        }
+        due += period;
+        if ((int32_t)(now - due) >= 0) {
+            // Fell behind by more than a period: resync rather than burst
+            due = now + period;
+        }
+        if (period > lead()) {
+            device->sleep();
+            awakeUs += clock() - awakeSince;
+            current = MLX90615_POWER_ASLEEP;
+        }
+        return status ? status : 1;
+    }
+
+    /** MLX90615_POWER_AWAKE ... MLX90615_POWER_SETTLING */
+    uint8_t state() {
+        return current;
+    }
+
+    /**
+        Fraction of the time the device was awake since begin(): the average
+        supply current is about duty * active current (sleep current aside).
+    */
+    float duty() {
+        uint32_t now = clock();
+        uint32_t awake = awakeUs;
+        if (current != MLX90615_POWER_ASLEEP && current != MLX90615_POWER_WAKING) {
+            awake += now - awakeSince;
+        }
+        return now != started ? (float)awake / (now - started) : 1.0;
+    }
+
+    /** Delay of the last read after its scheduled time, in us */
+    uint32_t latency() {
+        return lastLatency;
+    }
+
+    /** Largest delay of a read after its scheduled time, in us */
+    uint32_t worstLatency() {
+        return maxLatency;
+    }
+};
+
+#endif // __MLX90615_POWER_H__
@@ -0,0 +1,218 @@
+#ifndef __MLX90615_RING_H__
+#define __MLX90615_RING_H__
+
+#include <Arduino.h>
+#include <I2cMaster.h>
+#include <MLX90615.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+    One raw register reading, as queued by MLX90615Acquisition
+*/
+struct MLX90615Sample {
+    uint32_t timestamp;     // micros() when the read completed on the bus
+    uint16_t value;         // Raw register value, valid if status is 0
+    uint8_t device;         // Channel index in the acquisition table
+    uint8_t reg;            // MLX90615 register read
+    int8_t status;          // readReg() status
+};
+
+// Compiler barrier: keep the slot accesses between the index load and
+// the index store of each side
+#define MLX90615_RING_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+/**
+    Single producer, single consumer ring buffer of samples.
+
+    The producer (an interrupt, or whoever calls push) only writes head,
+    the consumer (loop) only writes tail, so neither side ever waits or
+    disables interrupts. When full, new samples are dropped and counted.
+    N must be a power of two, at most 128.
+*/
+template <uint8_t N>
+class MLX90615Ring {
+
+    static_assert(N && !(N & (N - 1)) && N <= 128, "N must be a power of two <= 128");
+
+  protected:
+    MLX90615Sample samples[N];
+    volatile uint8_t head;      // Next slot to write (free running)
+    volatile uint8_t tail;      // Next slot to read (free running)
+    volatile uint16_t overruns;
+
+  public:
+
+    MLX90615Ring() {
+        head = 0;
+        tail = 0;
+        overruns = 0;
+    }
+
+    /**
+        Producer side: queue a sample
+        @return: false if the ring was full (the sample is dropped)
+    */
+    bool push(const MLX90615Sample& sample) {
+        uint8_t h = head;
+        if ((uint8_t)(h - tail) >= N) {
+            overruns++;
+            return false;
+        }
+        MLX90615_RING_BARRIER();
+        samples[h & (N - 1)] = sample;
+        MLX90615_RING_BARRIER();
+        head = h + 1;
+        return true;
+    }
+
+    /**
+        Consumer side: take up to max samples, oldest first
+        @return: number of samples copied to out
+    */
+    uint8_t drain(MLX90615Sample* out, uint8_t max) {
+        uint8_t t = tail;
+        uint8_t count = head - t;
+        if (count > max) {
+            count = max;
+        }
+        MLX90615_RING_BARRIER();
+        for (uint8_t i = 0; i < count; i++) {
+            out[i] = samples[(uint8_t)(t + i) & (N - 1)];
+        }
+        MLX90615_RING_BARRIER();
+        tail = t + count;
+        return count;
+    }
+
+    /** Samples waiting for the consumer */
+    uint8_t available() {
+        return head - tail;
+    }
+
+    /** Samples dropped because the consumer was late */
+    uint16_t getOverruns() {
+        uint16_t value;
+        // 16-bit read is not atomic on 8-bit cores: read until stable
+        do {
+            value = overruns;
+        } while (value != overruns);
+        return value;
+    }
+};
+
+/**
+    Acquisition of MLX90615 registers into a MLX90615Ring, decoupled from
+    the consumer: a timer interrupt calls service() (or loop/engine code
+    calls serviceAsync()) at the sampling cadence, and loop() drains the
+    ring in batches whenever it gets to it.
+
+    CHANNELS: capacity of the table of (device, register) to sample.
+    N: ring size, power of two.
+
+    service() reads with the blocking readReg, so from an interrupt use a
+    bus that does not need interrupts itself (SoftI2cMaster,
+    FastSoftI2cMaster), not Wire on AVR.
+*/
+template <uint8_t CHANNELS, uint8_t N>
+class MLX90615Acquisition {
+
+  protected:
+    // Async request and the time it completed, stamped by the engine
+    struct TimedRead {
+        MLX90615AsyncRead read;     // First member: its transfer is the callback argument
+        volatile uint32_t completed;
+    };
+
+    MLX90615* devices[CHANNELS];
+    uint8_t regs[CHANNELS];
+    uint8_t count;
+    volatile uint8_t next;
+    uint8_t pending;                // Channel of the async request in flight
+    TimedRead request;
+
+    void advance() {
+        next = next + 1 < count ? next + 1 : 0;
+    }
+
+    static void stamp(I2cTransfer* transfer) {
+        reinterpret_cast<TimedRead*>(transfer)->completed = micros();
+    }
+
+  public:
+    MLX90615Ring<N> ring;
+
+    MLX90615Acquisition() {
+        count = 0;
+        next = 0;
+        pending = 0;
+        request.read.transfer.status = I2C_DONE;
+        request.read.transfer.context = 0;
+        request.completed = 0;
+    }
+
+    /**
+        Add a (device, register) pair to sample
+        @return: channel index, stored as MLX90615Sample::device, or -1 if full
+    */
+    int add(MLX90615* device, uint8_t reg = MLX90615_OBJECT_TEMPERATURE) {
+        if (count >= CHANNELS) {
+            return -1;
+        }
+        devices[count] = device;
+        regs[count] = reg;
+        return count++;
+    }
+
+    /**
+        Read the next channel and queue the sample. Meant to be called from
+        a timer interrupt: one call per sampling tick.
+    */
+    void service() {
+        if (!count) {
+            return;
+        }
+        uint8_t channel = next;
+        MLX90615Sample sample;
+        sample.value = 0;
+        sample.status = devices[channel]->readReg(regs[channel], &sample.value);
+        sample.timestamp = micros();
+        sample.device = channel;
+        sample.reg = regs[channel];
+        ring.push(sample);
+        advance();
+    }
+
+    /**
+        Non-blocking variant on an I2cAsync engine: queues the read of the
+        next channel, or collects the finished one into the ring. Call
+        along with engine->poll(); returns at once either way. The sample
+        is stamped by the engine when the transfer completes, not when it
+        is collected here.
+        @return: true if a sample was queued into the ring
+    */
+    bool serviceAsync(I2cAsync* engine) {
+        if (!count || request.read.transfer.status == I2C_PENDING) {
+            return false;
+        }
+        bool queued = false;
+        if (request.read.transfer.context) {
+            MLX90615Sample sample;
+            sample.value = 0;
+            sample.status = MLX90615::readRegResult(&request.read, &sample.value);
+            sample.timestamp = request.completed;
+            sample.device = pending;
+            sample.reg = regs[pending];
+            ring.push(sample);
+            request.read.transfer.context = 0;
+            queued = true;
+        }
+        pending = next;
+        if (devices[pending]->readRegAsync(engine, regs[pending], &request.read, stamp) != 1) {
+            advance();
+        }
+        return queued;
+    }
+};
+
+#endif // __MLX90615_RING_H__
@@ -0,0 +1,209 @@
+#ifndef __MLX90615_SCAN_H__
+#define __MLX90615_SCAN_H__
+
+#include <Arduino.h>
+#include <MLX90615.h>
+#include <MLX90615Eeprom.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// 7-bit addresses outside this range are reserved by the I2C specification
+#define MLX90615_SCAN_FIRST     0x08
+#define MLX90615_SCAN_LAST      0x77
+
+// Address every MLX90615 answers to, whatever its slave address
+#define MLX90615_GENERAL_ADDR   0x00
+
+/**
+    Discovery of MLX90615 devices on a bus.
+
+    Each address is read once, without retries: the slave address cell
+    (MLX90615_EEPROM_SA) with its PEC. A correct PEC is the identity test,
+    as other I2C devices won't produce one. An empty address stops the read
+    at the address Nak (10 SCL cycles), so the whole range costs little more
+    than a plain probe of each address. setQuickProbe() adds an empty write
+    before the read, for buses where a failed read is slower than that.
+*/
+class MLX90615Scanner {
+
+  protected:
+    MLX90615AnyTransport transport;
+    bool quick;
+    uint16_t probes;
+    uint16_t reads;
+
+  public:
+
+    explicit MLX90615Scanner(I2cMasterBase* i2c) : transport(i2c) {
+        quick = false;
+        probes = 0;
+        reads = 0;
+    }
+
+    explicit MLX90615Scanner(TwoWire* i2c) : transport(i2c) {
+        quick = false;
+        probes = 0;
+        reads = 0;
+    }
+
+    /** Probe each address with an empty write before reading it */
+    void setQuickProbe(bool enable) {
+        quick = enable;
+    }
+
+    /**
+        Test one address
+        @param addr: 7-bit address
+        @param sa: Pointer to store the slave address cell, may be 0
+        @return: status:   0  MLX90615 found
+                         -1  Bad CRC calc: some other device, or several
+                             MLX90615 answering together
+                         -2  I2C Error: no device
+    */
+    int identify(uint8_t addr, uint16_t* sa = 0) {
+        MLX90615T<MLX90615AnyTransport> device(addr, transport);
+        device.setRetries(0);
+        if (quick) {
+            probes++;
+            int status = device.probe();
+            if (status) {
+                return status;
+            }
+        }
+        reads++;
+        uint16_t value;
+        int status = device.readReg(MLX90615_EEPROM_SA, &value);
+        if (!status && sa) {
+            *sa = value;
+        }
+        return status;
+    }
+
+    /**
+        Scan the non-reserved 7-bit address space
+        @param found: Array to store the addresses of the devices found
+        @param max: Size of found
+        @param first, last: Range of addresses, last is capped at 0x7F
+        @return: number of devices found (only the first max are stored)
+    */
+    uint8_t scan(uint8_t* found, uint8_t max,
+                 uint8_t first = MLX90615_SCAN_FIRST, uint8_t last = MLX90615_SCAN_LAST) {
+        uint8_t count = 0;
+        if (last > 0x7F) {
+            last = 0x7F;
+        }
+        // Wider than an address, so the loop ends even at last = 0xFF
+        for (uint16_t addr = first; addr <= last; addr++) {
+            if (identify((uint8_t)addr) == 0) {
+                if (count < max) {
+                    found[count] = addr;
+                }
+                count++;
+            }
+        }
+        return count;
+    }
+
+    /** Probes and PEC reads issued since construction */
+    uint16_t getProbes() {
+        return probes;
+    }
+
+    uint16_t getReads() {
+        return reads;
+    }
+};
+
+/**
+    Address provisioning through the general address 0x00: connect one
+    new device at a time (alone on the bus answering 0x00, e.g. on a
+    provisioning jig), and give it the next free address of a range.
+    The address is written with MLX90615Eeprom (erase, write, read back);
+    the device uses it after its next power cycle.
+*/
+class MLX90615Provisioner {
+
+  protected:
+    MLX90615 device;        // At MLX90615_GENERAL_ADDR
+    uint8_t next;
+    uint8_t last;
+    uint32_t (*clock)(void);
+
+  public:
+
+    /**
+        @param first, end: Range of addresses to hand out
+    */
+    MLX90615Provisioner(I2cMasterBase* i2c, uint8_t first, uint8_t end) :
+        device(MLX90615_GENERAL_ADDR, i2c) {
+        next = first;
+        last = end;
+        clock = 0;
+    }
+
+    MLX90615Provisioner(TwoWire* i2c, uint8_t first, uint8_t end) :
+        device(MLX90615_GENERAL_ADDR, i2c) {
+        next = first;
+        last = end;
+        clock = 0;
+    }
+
+    /** Replace micros() as time base of the EEPROM waits (e.g. a simulated bus clock) */
+    void setClock(uint32_t (*us)(void)) {
+        clock = us;
+    }
+
+    /** True if a device answers the general address */
+    bool present() {
+        return device.probe() == 0;
+    }
+
+    /**
+        Write the slave address of the device on the bus
+        @param addr: New 7-bit address, MLX90615_SCAN_FIRST to MLX90615_SCAN_LAST
+        @return: status:   0  OK, written and verified (or already set)
+                         -1  Bad CRC calc: more than one device answering
+                         -2  I2C Error: no device
+                         -3  Reserved address (0x00-0x07, 0x78-0x7F) or
+                             not a 7-bit one: nothing written
+                         -5  Read back differs from the value written
+                         -7  Cell erased but not written, after
+                             MLX90615_DEFAULT_RETRIES more attempts: the
+                             device is left with address 0x00
+    */
+    int provision(uint8_t addr) {
+        if (addr < MLX90615_SCAN_FIRST || addr > MLX90615_SCAN_LAST) {
+            return -3;
+        }
+        MLX90615Eeprom eeprom(&device);
+        if (clock) {
+            eeprom.setClock(clock);
+        }
+        int status = eeprom.load();
+        if (status) {
+            return status;
+        }
+        eeprom.setBits(MLX90615_EEPROM_SA, 0x007F, addr);
+        uint8_t attempt = 0;
+        while ((status = eeprom.commit()) == -7 && attempt++ < MLX90615_DEFAULT_RETRIES);
+        return status;
+    }
+
+    /**
+        Give the device on the bus the next address of the range
+        @param assigned: Pointer to store the address given
+        @return: status, as provision(), or -6 if the range is used up
+    */
+    int provisionNext(uint8_t* assigned) {
+        if (next > last) {
+            return -6;
+        }
+        int status = provision(next);
+        if (!status) {
+            *assigned = next++;
+        }
+        return status;
+    }
+};
+
+#endif // __MLX90615_SCAN_H__
@@ -0,0 +1,519 @@
+#ifndef __MLX90615_SIM_H__
+#define __MLX90615_SIM_H__
+
+#include <Arduino.h>
+#include <I2cMaster.h>
+#include <MLX90615.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+    Simulated MLX90615 devices and an I2cMasterBase bus to talk to them.
+
+    Nothing here touches real pins: the bus keeps its own clock (counted
+    in SCL cycles) so driver changes can be measured as transactions,
+    bytes and bus time on any board, or off-target with an Arduino shim.
+*/
+
+#define MLX90615_SIM_MAX_DEVICES        8
+#define MLX90615_SIM_EEPROM_WORDS       16
+#define MLX90615_SIM_EEPROM_WRITE_US    5000    // Erase or write cell time
+#define MLX90615_SIM_WAKE_PULSE_US      39000   // Shortest SCL low that wakes up
+#define MLX90615_SIM_WAKE_VALID_US      250000  // Wake-up to first valid data
+#define MLX90615_SIM_SHAPE_MAX          32      // Steps kept by SimI2cMaster::shape()
+
+/**
+    Bus activity counters, as accumulated by SimI2cMaster.
+*/
+struct I2cBusStats {
+    uint32_t transactions;  // START conditions (not counting restarts)
+    uint32_t restarts;
+    uint32_t bytes;         // Address and data bytes, both directions
+    uint32_t naks;
+    uint32_t sclCycles;     // 9 per byte, 1 per START/restart/STOP
+};
+
+class MLX90615Sim {
+
+  protected:
+    uint16_t ram[3];                                // 0x25, 0x26, 0x27
+    uint16_t eeprom[MLX90615_SIM_EEPROM_WORDS];     // 0x10 .. 0x1F
+    uint32_t busyUntil;                             // EEPROM cell write in progress
+
+    uint8_t frame[6];
+    uint8_t frameLen;
+    uint8_t readPos;
+
+    uint8_t badPecs;                                // Injected faults still to come
+    uint8_t naks;
+    uint16_t stuckClocks;                           // SCL pulses until SDA is released
+    uint8_t slaveAddress;
+
+    bool asleep;
+    uint32_t validFrom;                             // First valid data after wake-up
+    uint32_t awakeSince;
+    uint32_t awakeUs;                               // Time awake before awakeSince
+
+  public:
+
+    MLX90615Sim(uint8_t addr = MLX90615_DefaultAddr) {
+        for (uint8_t i = 0; i < MLX90615_SIM_EEPROM_WORDS; i++) {
+            eeprom[i] = 0;
+        }
+        eeprom[MLX90615_EEPROM_SA - 0x10] = addr & 0x7f;
+        slaveAddress = addr & 0x7f;
+        eeprom[MLX90615_EEPROM_PWMT_RNG - 0x10] = 0x1d6e;
+        eeprom[MLX90615_EEPROM_CONFIG - 0x10] = 0x14e9;
+        eeprom[MLX90615_EEPROM_EMISSIVITY - 0x10] = Default_Emissivity;
+        busyUntil = 0;
+        frameLen = 0;
+        readPos = 0;
+        badPecs = 0;
+        naks = 0;
+        stuckClocks = 0;
+        asleep = false;
+        validFrom = 0;
+        awakeSince = 0;
+        awakeUs = 0;
+        setTemperature(MLX90615_AMBIENT_TEMPERATURE, 25.0);
+        setTemperature(MLX90615_OBJECT_TEMPERATURE, 25.0);
+        setRaw(MLX90615_RAW_IR_DATA, 0);
+    }
+
+    /**
+        Slave address as last written to EEPROM (takes effect at once,
+        which is more forgiving than the real part's power cycle; the
+        erase before a write keeps the previous address).
+    */
+    uint8_t address() {
+        return slaveAddress;
+    }
+
+    /**
+        Set a RAM register (MLX90615_RAW_IR_DATA, MLX90615_AMBIENT_TEMPERATURE
+        or MLX90615_OBJECT_TEMPERATURE) to a raw value.
+    */
+    void setRaw(uint8_t reg, uint16_t value) {
+        if (reg >= MLX90615_RAW_IR_DATA && reg <= MLX90615_OBJECT_TEMPERATURE) {
+            ram[reg - MLX90615_RAW_IR_DATA] = value;
+        }
+    }
+
+    /** Set a temperature register in Celsius, using the 0.02 K/LSB scale. */
+    void setTemperature(uint8_t reg, float celsius) {
+        setRaw(reg, (uint16_t)((celsius + 273.15 + 0.01) / 0.02 + 0.5));
+    }
+
+    /** Current content of a 0x10..0x1F EEPROM cell. */
+    uint16_t getEEPROM(uint8_t reg) {
+        return eeprom[(reg - 0x10) & (MLX90615_SIM_EEPROM_WORDS - 1)];
+    }
+
+    /** Send a wrong PEC on the next count reads (a noisy line). */
+    void injectBadPec(uint8_t count) {
+        badPecs = count;
+    }
+
+    /** Do not acknowledge the next count addressings. */
+    void injectNak(uint8_t count) {
+        naks = count;
+    }
+
+    /**
+        Hold SDA low until clocks SCL pulses have been seen, as a slave cut
+        off in the middle of a read does. 0xFFFF holds it for good.
+    */
+    void injectStuckSda(uint16_t clocks) {
+        stuckClocks = clocks;
+    }
+
+    /** True while the device holds SDA low. */
+    bool holdsSda() {
+        return stuckClocks != 0;
+    }
+
+    /** True between a sleep command and a wake-up pulse. */
+    bool sleeping() {
+        return asleep;
+    }
+
+    /** Total time spent awake up to now, in us: proportional to the charge used. */
+    uint32_t awakeTime(uint32_t now) {
+        return awakeUs + (asleep ? 0 : now - awakeSince);
+    }
+
+    /** True while an EEPROM erase/write is still in progress at time now. */
+    bool busy(uint32_t now) {
+        return (int32_t)(busyUntil - now) > 0;
+    }
+
+    //--------------------------------------------------------------------
+    // Bus side, called by SimI2cMaster
+
+    bool matches(uint8_t addr7) {
+        return addr7 == 0x00 || addr7 == address();
+    }
+
+    /** START/restart addressed to this device. Returns the Ack. */
+    bool onStart(uint8_t addressRW, uint32_t now) {
+        if (asleep || busy(now)) {
+            return false;
+        }
+        if (naks) {
+            naks--;
+            return false;
+        }
+        if (addressRW & I2C_READ) {
+            // Read word: lsb, msb, pec over the whole frame
+            uint16_t value = readWord(frameLen >= 2 ? frame[1] : 0);
+            if ((int32_t)(validFrom - now) > 0 && frame[1] >= MLX90615_RAW_IR_DATA) {
+                value = 0; // No conversion yet after wake-up
+            }
+            frame[2] = addressRW;
+            frameLen = 3;
+            frame[3] = value & 0xff;
+            frame[4] = value >> 8;
+            frame[5] = mlx90615Crc8(0x00, frame, 5);
+            if (badPecs) {
+                badPecs--;
+                frame[5] ^= 0x10;
+            }
+            readPos = 3;
+        } else {
+            frame[0] = addressRW;
+            frameLen = 1;
+            readPos = 0;
+        }
+        return true;
+    }
+
+    bool onWrite(uint8_t data) {
+        if (frameLen >= 5) {
+            return false;
+        }
+        frame[frameLen++] = data;
+        return true;
+    }
+
+    /** SCL was held low for duration us with the bus idle, until now. */
+    void onSclLow(uint32_t duration, uint32_t now) {
+        if (asleep && duration >= MLX90615_SIM_WAKE_PULSE_US) {
+            asleep = false;
+            awakeSince = now;
+            validFrom = now + MLX90615_SIM_WAKE_VALID_US;
+        }
+    }
+
+    /** SCL pulses without a transfer (bus recovery). */
+    void onClocks(uint8_t pulses) {
+        if (stuckClocks == 0xFFFF) {
+            return;
+        }
+        stuckClocks = stuckClocks > pulses ? stuckClocks - pulses : 0;
+    }
+
+    uint8_t onRead() {
+        return readPos < 6 ? frame[readPos++] : 0xff;
+    }
+
+    void onStop(uint32_t now) {
+        if (!readPos && frameLen == 5 && !mlx90615Crc8(0x00, frame, 5)) {
+            writeWord(frame[1], (uint16_t)frame[3] << 8 | frame[2], now);
+        }
+        if (!readPos && frameLen == 3 && frame[1] == MLX90615_SLEEP && !mlx90615Crc8(0x00, frame, 3)) {
+            asleep = true;
+            awakeUs += now - awakeSince;
+        }
+        frameLen = 0;
+        readPos = 0;
+    }
+
+  protected:
+
+    uint16_t readWord(uint8_t cmd) {
+        if (cmd >= MLX90615_RAW_IR_DATA && cmd <= MLX90615_OBJECT_TEMPERATURE) {
+            return ram[cmd - MLX90615_RAW_IR_DATA];
+        }
+        if ((cmd & 0xf0) == 0x10) {
+            return eeprom[cmd & 0x0f];
+        }
+        return 0xffff;
+    }
+
+    void writeWord(uint8_t cmd, uint16_t value, uint32_t now) {
+        if (cmd < MLX90615_EEPROM_SA || cmd > MLX90615_EEPROM_EMISSIVITY) {
+            return;
+        }
+        uint16_t* cell = &eeprom[cmd & 0x0f];
+        if (value == 0x0000) {
+            *cell = 0x0000;
+        } else {
+            // Without a prior erase, bits can only be set
+            *cell |= value;
+            if (cmd == MLX90615_EEPROM_SA) {
+                slaveAddress = *cell & 0x7f;
+            }
+        }
+        busyUntil = now + MLX90615_SIM_EEPROM_WRITE_US;
+    }
+};
+
+/**
+    I2cMasterBase implementation backed by simulated devices.
+
+    shape() spells the steps of the last transaction, one letter each:
+    S start, R repeated start, A address acked, N address not acked,
+    W byte written and acked, X byte written and not acked, r byte read
+    and acked, n last byte read (not acked), P stop. A register read is
+    "SAWRArrnP", a register write "SAWWWWP".
+
+    A device holding SDA low (MLX90615Sim::injectStuckSda()) blocks every
+    START: the master gives up after I2C_TIMEOUT_USEC of simulated time,
+    counted as a Nak and spelled T. recover() spells one C per SCL pulse,
+    e.g. "CCCP".
+*/
+class SimI2cMaster : public I2cMasterBase {
+
+  protected:
+    MLX90615Sim* devices[MLX90615_SIM_MAX_DEVICES];
+    uint8_t count;
+    uint8_t selected;       // Bitmask of devices that acked the address
+    uint32_t sclHz;
+    uint32_t idleUs;
+    uint32_t totalCycles;   // Not cleared by resetStats(), drives micros()
+    uint32_t sclLowSince;
+    bool sclLow;
+    I2cBusStats counters;
+    char steps[MLX90615_SIM_SHAPE_MAX + 1];
+    uint8_t stepCount;
+
+    void step(char c) {
+        if (stepCount < MLX90615_SIM_SHAPE_MAX) {
+            steps[stepCount++] = c;
+            steps[stepCount] = 0;
+        }
+    }
+
+    void clock(uint32_t cycles) {
+        counters.sclCycles += cycles;
+        totalCycles += cycles;
+    }
+
+    bool stuck() {
+        for (uint8_t i = 0; i < count; i++) {
+            if (devices[i]->holdsSda()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool address(uint8_t addressRW) {
+        I2C_TRACE_BEGIN();
+        selected = 0;
+        if (stuck()) {
+            // No START possible: wait for the bus until the timeout
+            idleUs += I2C_TIMEOUT_USEC;
+            counters.naks++;
+            step('T');
+            I2C_TRACE_END(I2C_PHASE_START, false);
+            return false;
+        }
+        clock(1);
+        I2C_TRACE_MARK(I2C_PHASE_START, true);
+        clock(9);
+        counters.bytes++;
+        uint32_t now = micros();
+        for (uint8_t i = 0; i < count; i++) {
+            if (devices[i]->matches(addressRW >> 1) && devices[i]->onStart(addressRW, now)) {
+                selected |= 1 << i;
+            }
+        }
+        if (!selected) {
+            counters.naks++;
+        }
+        step(selected ? 'A' : 'N');
+        I2C_TRACE_END(I2C_PHASE_ADDRESS, selected != 0);
+        return selected != 0;
+    }
+
+  public:
+
+    SimI2cMaster(uint32_t hz = 100000) {
+        count = 0;
+        selected = 0;
+        sclHz = hz;
+        idleUs = 0;
+        totalCycles = 0;
+        sclLowSince = 0;
+        sclLow = false;
+        stepCount = 0;
+        steps[0] = 0;
+        resetStats();
+    }
+
+    /** Connect a simulated device; returns false when the bus is full. */
+    bool attach(MLX90615Sim* device) {
+        if (count >= MLX90615_SIM_MAX_DEVICES) {
+            return false;
+        }
+        devices[count++] = device;
+        return true;
+    }
+
+    /** Disconnect a simulated device. */
+    void detach(MLX90615Sim* device) {
+        for (uint8_t i = 0; i < count; i++) {
+            if (devices[i] == device) {
+                devices[i] = devices[--count];
+                return;
+            }
+        }
+    }
+
+    void setClock(uint32_t hz) {
+        sclHz = hz;
+    }
+
+    uint32_t getClock() {
+        return sclHz;
+    }
+
+    /** Let simulated time pass without bus activity (e.g. delay()). */
+    void advance(uint32_t us) {
+        idleUs += us;
+    }
+
+    /** Simulated time in microseconds: bus activity plus advance() calls. */
+    uint32_t micros() {
+        return idleUs + busMicros(totalCycles);
+    }
+
+    /** Convert SCL cycles to microseconds at the current clock. */
+    uint32_t busMicros(uint32_t cycles) {
+        return (uint32_t)((uint64_t)cycles * 1000000UL / sclHz);
+    }
+
+    I2cBusStats stats() {
+        return counters;
+    }
+
+    /** Steps of the last transaction, from its start (see above) */
+    const char* shape() {
+        return steps;
+    }
+
+    void resetStats() {
+        counters.transactions = 0;
+        counters.restarts = 0;
+        counters.bytes = 0;
+        counters.naks = 0;
+        counters.sclCycles = 0;
+    }
+
+    //--------------------------------------------------------------------
+    // I2cMasterBase
+
+    uint8_t read(uint8_t last) {
+        I2C_TRACE_BEGIN();
+        clock(9);
+        counters.bytes++;
+        uint8_t b = 0xff;
+        for (uint8_t i = 0; i < count; i++) {
+            if (selected & (1 << i)) {
+                // Open drain: any device pulling low wins
+                b &= devices[i]->onRead();
+            }
+        }
+        step(last ? 'n' : 'r');
+        I2C_TRACE_END(I2C_PHASE_DATA, true);
+        return b;
+    }
+
+    bool restart(uint8_t addressRW) {
+        counters.restarts++;
+        step('R');
+        return address(addressRW);
+    }
+
+    bool start(uint8_t addressRW) {
+        counters.transactions++;
+        stepCount = 0;
+        step('S');
+        return address(addressRW);
+    }
+
+    void stop(void) {
+        I2C_TRACE_BEGIN();
+        clock(1);
+        step('P');
+        I2C_TRACE_END(I2C_PHASE_STOP, true);
+        uint32_t now = micros();
+        for (uint8_t i = 0; i < count; i++) {
+            if (selected & (1 << i)) {
+                devices[i]->onStop(now);
+            }
+        }
+        selected = 0;
+    }
+
+    void holdScl(bool low) {
+        uint32_t now = micros();
+        if (low && !sclLow) {
+            sclLowSince = now;
+        } else if (!low && sclLow) {
+            for (uint8_t i = 0; i < count; i++) {
+                devices[i]->onSclLow(now - sclLowSince, now);
+            }
+        }
+        sclLow = low;
+    }
+
+    bool recover(void) {
+        stepCount = 0;
+        for (uint8_t pulse = 0; pulse < I2C_RECOVER_CLOCKS && stuck(); pulse++) {
+            clock(1);
+            step('C');
+            for (uint8_t i = 0; i < count; i++) {
+                devices[i]->onClocks(1);
+            }
+        }
+        bool released = !stuck();
+        stop();
+        return released;
+    }
+
+    bool write(uint8_t data) {
+        I2C_TRACE_BEGIN();
+        clock(9);
+        counters.bytes++;
+        bool ack = false;
+        for (uint8_t i = 0; i < count; i++) {
+            if (selected & (1 << i)) {
+                ack |= devices[i]->onWrite(data);
+            }
+        }
+        if (!ack) {
+            counters.naks++;
+        }
+        step(ack ? 'W' : 'X');
+        I2C_TRACE_END(I2C_PHASE_DATA, ack);
+        return ack;
+    }
+};
+
+/** Compile-time bound transport for MLX90615T<MLX90615SimTransport> */
+typedef MLX90615BusTransport<SimI2cMaster> MLX90615SimTransport;
+
+/** Difference between two snapshots of I2cBusStats. */
+inline I2cBusStats operator-(const I2cBusStats& a, const I2cBusStats& b) {
+    I2cBusStats d;
+    d.transactions = a.transactions - b.transactions;
+    d.restarts = a.restarts - b.restarts;
+    d.bytes = a.bytes - b.bytes;
+    d.naks = a.naks - b.naks;
+    d.sclCycles = a.sclCycles - b.sclCycles;
+    return d;
+}
+
+#endif // __MLX90615_SIM_H__
@@ -0,0 +1,282 @@
+#ifndef __MLX90615_TELEMETRY_H__
+#define __MLX90615_TELEMETRY_H__
+
+#include <Arduino.h>
+#include <MLX90615.h>
+#include <MLX90615Crc.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+    Packed binary frames of raw MLX90615 samples, for serial or radio links
+    where printing floats is too slow or too big.
+
+    Frame:
+    > 0      MLX90615_TELEMETRY_SYNC
+    > 1      flags: bit 7 keyframe, bits 0..2 fields (MLX90615_FIELD_*)
+    > 2      sequence number, +1 per frame
+    > 3      device bitmap, bit i set if device i is in the frame
+    > 4      payload length
+    > 5...   for each device in the bitmap, for each field (raw IR,
+             ambient, object): the raw value minus the one sent before for
+             that device, zigzag encoded, as a 1..3 byte varint (7 bits per
+             byte, LSB first, bit 7 set if more bytes follow).
+             Keyframes send differences to 0, i.e. absolute values.
+    > last   CRC-8 (SMBus polynomial, as the PEC) of all the bytes before
+
+    A stable reading costs 1 byte per value instead of the ~8 characters of
+    "36.60°C ". Delta frames need the frame before: the decoder drops them
+    after a sequence gap until the next keyframe, sent every
+    keyframeInterval frames, and as soon as a device not sent since the
+    last keyframe joins the bitmap.
+
+    The decoder only depends on MLX90615Crc.h, so it can be built for the
+    receiving host as well.
+*/
+
+#define MLX90615_TELEMETRY_SYNC         0xA5
+#define MLX90615_TELEMETRY_KEYFRAME     0x80
+
+#define MLX90615_FIELD_RAW_IR           0x01
+#define MLX90615_FIELD_AMBIENT          0x02
+#define MLX90615_FIELD_OBJECT           0x04
+
+#define MLX90615_TELEMETRY_HEADER       5
+// Largest frame for devices x fields values
+#define MLX90615_TELEMETRY_MAX_FRAME(values)    (MLX90615_TELEMETRY_HEADER + 3 * (values) + 1)
+
+/**
+    State shared by encoder and decoder: the last value sent per device
+*/
+template <uint8_t N>
+class MLX90615TelemetryState {
+
+    static_assert(N > 0 && N <= 8, "N must be 1..8 (device bitmap)");
+
+  protected:
+    MLX90615Data previous[N];
+    uint8_t sequence;
+
+    void clear() {
+        for (uint8_t i = 0; i < N; i++) {
+            previous[i].rawIr = 0;
+            previous[i].ambient = 0;
+            previous[i].object = 0;
+        }
+    }
+
+    static uint16_t get(const MLX90615Data* data, uint8_t bit) {
+        return bit == MLX90615_FIELD_RAW_IR ? data->rawIr :
+               bit == MLX90615_FIELD_AMBIENT ? data->ambient : data->object;
+    }
+
+    static uint16_t* field(MLX90615Data* data, uint8_t bit) {
+        return bit == MLX90615_FIELD_RAW_IR ? &data->rawIr :
+               bit == MLX90615_FIELD_AMBIENT ? &data->ambient : &data->object;
+    }
+};
+
+/**
+    Encoder of telemetry frames for up to N (<= 8) devices
+*/
+template <uint8_t N>
+class MLX90615TelemetryEncoder : public MLX90615TelemetryState<N> {
+
+    typedef MLX90615TelemetryState<N> State;
+
+  protected:
+    uint8_t fields;
+    uint8_t keyframeInterval;
+    uint8_t sinceKeyframe;
+    uint8_t sent;           // Devices sent since the last keyframe
+
+  public:
+
+    /**
+        @param mask: Fields sent per device (MLX90615_FIELD_*)
+        @param interval: Frames between keyframes (1 = keyframes only)
+    */
+    MLX90615TelemetryEncoder(uint8_t mask = MLX90615_FIELD_AMBIENT | MLX90615_FIELD_OBJECT,
+                             uint8_t interval = 16) {
+        fields = mask & 0x07;
+        keyframeInterval = interval ? interval : 1;
+        sent = 0;
+        State::sequence = 0;
+        State::clear();
+        restart();
+    }
+
+    /** Make the next frame a keyframe (e.g. when a receiver connects) */
+    void restart() {
+        sinceKeyframe = 0;
+    }
+
+    /**
+        Encode one frame
+        @param samples: Array of N samples indexed by device, as read by readAll()
+        @param bitmap: Devices to include (bit i for samples[i]), e.g. the
+                       ones read with status 0
+        @param frame: Output buffer, see MLX90615_TELEMETRY_MAX_FRAME
+        @param size: Size of frame
+        @return: frame length, 0 if it did not fit in size
+    */
+    uint8_t encode(const MLX90615Data* samples, uint8_t bitmap, uint8_t* frame, uint8_t size) {
+        // A device new to the receiver has no reference for a delta
+        bool keyframe = sinceKeyframe == 0 || (bitmap & ~sent);
+        uint8_t pos = MLX90615_TELEMETRY_HEADER;
+        if (size < pos + 1) {
+            return 0;
+        }
+        for (uint8_t dev = 0; dev < N; dev++) {
+            if (!(bitmap & (1 << dev))) {
+                continue;
+            }
+            for (uint8_t bit = MLX90615_FIELD_RAW_IR; bit <= MLX90615_FIELD_OBJECT; bit <<= 1) {
+                if (!(fields & bit)) {
+                    continue;
+                }
+                uint16_t delta = State::get(&samples[dev], bit) -
+                                 (keyframe ? 0 : State::get(&State::previous[dev], bit));
+                uint16_t zigzag = (delta << 1) ^ ((delta & 0x8000) ? 0xFFFF : 0);
+                do {
+                    if (pos + 1 >= size) {
+                        return 0;
+                    }
+                    frame[pos++] = (zigzag & 0x7F) | (zigzag > 0x7F ? 0x80 : 0);
+                    zigzag >>= 7;
+                } while (zigzag);
+            }
+        }
+        frame[0] = MLX90615_TELEMETRY_SYNC;
+        frame[1] = fields | (keyframe ? MLX90615_TELEMETRY_KEYFRAME : 0);
+        frame[2] = State::sequence;
+        frame[3] = bitmap & (uint8_t)((1 << N) - 1);
+        frame[4] = pos - MLX90615_TELEMETRY_HEADER;
+        frame[pos] = mlx90615Crc8(0, frame, pos);
+
+        // Commit: only now the frame is complete
+        for (uint8_t dev = 0; dev < N; dev++) {
+            if (bitmap & (1 << dev)) {
+                State::previous[dev] = samples[dev];
+            }
+        }
+        State::sequence++;
+        if (keyframe) {
+            sent = 0;
+            sinceKeyframe = 0;
+        }
+        sent |= frame[3];
+        sinceKeyframe = sinceKeyframe + 1 < keyframeInterval ? sinceKeyframe + 1 : 0;
+        return pos + 1;
+    }
+};
+
+/**
+    Decoder of telemetry frames for up to N (<= 8) devices
+*/
+template <uint8_t N>
+class MLX90615TelemetryDecoder : public MLX90615TelemetryState<N> {
+
+    typedef MLX90615TelemetryState<N> State;
+
+  protected:
+    bool started;
+    uint8_t valid;          // Devices whose previous value is known
+    uint32_t lost;
+
+  public:
+
+    MLX90615TelemetryDecoder() {
+        started = false;
+        valid = 0;
+        lost = 0;
+        State::sequence = 0;
+        State::clear();
+    }
+
+    /**
+        Decode one frame
+        @param frame: Frame bytes, starting with MLX90615_TELEMETRY_SYNC
+        @param len: Bytes available in frame
+        @param samples: Array of N samples indexed by device; only the
+                        devices in *bitmap are written
+        @param bitmap: Devices present in the frame
+        @return: frame length (> 0), or status: -1  Bad CRC calc
+                                                -3  Not a (complete) frame
+                                                -4  Delta frame without its
+                                                    reference, wait for a keyframe
+    */
+    int decode(const uint8_t* frame, uint8_t len, MLX90615Data* samples, uint8_t* bitmap) {
+        if (len < MLX90615_TELEMETRY_HEADER + 1 || frame[0] != MLX90615_TELEMETRY_SYNC ||
+                frame[4] > len - MLX90615_TELEMETRY_HEADER - 1) {
+            return -3;
+        }
+        uint8_t end = MLX90615_TELEMETRY_HEADER + frame[4];
+        if (mlx90615Crc8(0, frame, end) != frame[end]) {
+            return -1;
+        }
+        bool keyframe = frame[1] & MLX90615_TELEMETRY_KEYFRAME;
+        uint8_t present = frame[3];
+        if (frame[2] != State::sequence || !started) {
+            if (started) {
+                lost += (uint8_t)(frame[2] - State::sequence);
+            }
+            // Missed frames: every reference is stale
+            valid = 0;
+        }
+        started = true;
+        State::sequence = frame[2] + 1;
+        if (!keyframe && (present & ~valid)) {
+            return -4;
+        }
+
+        uint8_t fields = frame[1] & 0x07;
+        MLX90615Data decoded[N];
+        uint8_t pos = MLX90615_TELEMETRY_HEADER;
+        for (uint8_t dev = 0; dev < N; dev++) {
+            if (!(present & (1 << dev))) {
+                continue;
+            }
+            decoded[dev] = State::previous[dev];
+            for (uint8_t bit = MLX90615_FIELD_RAW_IR; bit <= MLX90615_FIELD_OBJECT; bit <<= 1) {
+                if (!(fields & bit)) {
+                    continue;
+                }
+                uint16_t zigzag = 0;
+                uint8_t shift = 0;
+                uint8_t byte;
+                do {
+                    if (pos >= end || shift > 14) {
+                        return -3;
+                    }
+                    byte = frame[pos++];
+                    zigzag |= (uint16_t)(byte & 0x7F) << shift;
+                    shift += 7;
+                } while (byte & 0x80);
+                uint16_t delta = (zigzag >> 1) ^ ((zigzag & 1) ? 0xFFFF : 0);
+                uint16_t* value = State::field(&decoded[dev], bit);
+                *value = (keyframe ? 0 : *value) + delta;
+            }
+        }
+        if (pos != end) {
+            return -3;
+        }
+
+        for (uint8_t dev = 0; dev < N; dev++) {
+            if (present & (1 << dev)) {
+                State::previous[dev] = decoded[dev];
+                samples[dev] = decoded[dev];
+            }
+        }
+        *bitmap = present;
+        valid |= present;
+        return end + 1;
+    }
+
+    /** Frames missed, from sequence number gaps */
+    uint32_t getLost() {
+        return lost;
+    }
+};
+
+#endif // __MLX90615_TELEMETRY_H__
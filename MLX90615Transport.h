@@ -0,0 +1,416 @@
+#ifndef __MLX90615_TRANSPORT_H__
+#define __MLX90615_TRANSPORT_H__
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <I2cMaster.h>
+#include <MLX90615Crc.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+    Bus transports for MLX90615T<Transport>. A transport only moves SMBus
+    frames; PEC, retries and conversions are done by the driver on top.
+    Every transport provides:
+
+    > int readWord(uint8_t dev, uint8_t cmd, uint8_t* data, bool first, bool last)
+        Write cmd to dev (8-bit address), repeated start, read lsb, msb, pec
+        into data. first: open with a start (else a repeated start),
+        last: close with a stop (else keep the bus).
+    > void release(uint8_t dev)
+        Close a session early, after a readWord with last == false to
+        dev (8-bit address): the bus is stopped.
+    > int writeBytes(uint8_t dev, const uint8_t* data, uint8_t len)
+        Start, address, len bytes, stop.
+    > void holdScl(bool low)
+        Pull SCL low with the bus idle, or release it (wake-up pulse).
+        Only needed by sleep/wake (MLX90615T::beginWake()).
+    > bool recover()
+        Clock SCL until a slave holding SDA low lets it go (at most
+        I2C_RECOVER_CLOCKS pulses), then stop. True if SDA is high again.
+
+    Status: 0 OK, -2 I2C Error (the bus is released), -10 no bus.
+*/
+
+/**
+    Transport over an Arduino TwoWire (Wire, Wire1...)
+*/
+class MLX90615WireTransport {
+
+  protected:
+    TwoWire* wire;
+
+  public:
+
+    explicit MLX90615WireTransport(TwoWire* i2c) : wire(i2c) {}
+
+    int readWord(uint8_t dev, uint8_t cmd, uint8_t* data, bool first, bool last) {
+        (void)first;
+        wire->beginTransmission((uint8_t)(dev >> 1));
+        wire->write(cmd);
+        if (wire->endTransmission(false)) {
+            return -2;
+        }
+        if (wire->requestFrom((uint8_t)(dev >> 1), (uint8_t)3, (uint8_t)last) != 3) {
+            return -2;
+        }
+        data[0] = wire->read();
+        data[1] = wire->read();
+        data[2] = wire->read();
+        return 0;
+    }
+
+    /** Wire has no bare stop: an empty message to dev ends with one */
+    void release(uint8_t dev) {
+        wire->beginTransmission((uint8_t)(dev >> 1));
+        wire->endTransmission();
+    }
+
+    int writeBytes(uint8_t dev, const uint8_t* data, uint8_t len) {
+        wire->beginTransmission((uint8_t)(dev >> 1));
+        uint8_t sent = wire->write(data, len);
+        if (wire->endTransmission() || sent != len) {
+            return -2;
+        }
+        return 0;
+    }
+
+    /** Hand the pins over to the sketch: while Wire is begun the
+        peripheral drives them (the TWI, on AVR) and pinMode() does not */
+    static void end(TwoWire* i2c) {
+        #if defined(ARDUINO_ARCH_ESP8266)
+        (void)i2c;  // Software TWI, no end(): the pins are plain GPIOs
+        #else
+        i2c->end();
+        #endif
+    }
+
+    /** Drives the board's default SCL pin, then begin()s wire again */
+    void holdScl(bool low) {
+        #if defined(PIN_WIRE_SCL)
+        if (low) {
+            end(wire);
+            digitalWrite(PIN_WIRE_SCL, LOW);
+            pinMode(PIN_WIRE_SCL, OUTPUT);
+        } else {
+            pinMode(PIN_WIRE_SCL, INPUT);
+            wire->begin();
+        }
+        #else
+        (void)low;
+        #endif
+    }
+
+    /** Ends wire, clocks the board's default SCL pin while SDA is low, then begin()s wire again */
+    bool recover() {
+        bool released = true;
+        #if defined(PIN_WIRE_SCL) && defined(PIN_WIRE_SDA)
+        end(wire);
+        pinMode(PIN_WIRE_SDA, INPUT_PULLUP);
+        pinMode(PIN_WIRE_SCL, INPUT_PULLUP);
+        for (uint8_t i = 0; i < I2C_RECOVER_CLOCKS && !digitalRead(PIN_WIRE_SDA); i++) {
+            digitalWrite(PIN_WIRE_SCL, LOW);
+            pinMode(PIN_WIRE_SCL, OUTPUT);
+            delayMicroseconds(5);
+            pinMode(PIN_WIRE_SCL, INPUT_PULLUP);
+            delayMicroseconds(5);
+        }
+        released = digitalRead(PIN_WIRE_SDA);
+        #endif
+        wire->begin();
+        return released;
+    }
+};
+
+/**
+    Primitive calls on a concrete I2cMasterBase class, qualified so the
+    compiler binds (and can inline) them instead of going through the vtable
+*/
+template <class Bus>
+struct MLX90615BusOps {
+    static bool start(Bus* bus, uint8_t addressRW) {
+        return bus->Bus::start(addressRW);
+    }
+    static bool restart(Bus* bus, uint8_t addressRW) {
+        return bus->Bus::restart(addressRW);
+    }
+    static bool write(Bus* bus, uint8_t data) {
+        return bus->Bus::write(data);
+    }
+    static uint8_t read(Bus* bus, uint8_t last) {
+        return bus->Bus::read(last);
+    }
+    static void stop(Bus* bus) {
+        bus->Bus::stop();
+    }
+    static void holdScl(Bus* bus, bool low) {
+        bus->Bus::holdScl(low);
+    }
+    static bool recover(Bus* bus) {
+        return bus->Bus::recover();
+    }
+    /** I2cMasterBase::transfer() on the bound primitives */
+    static bool transfer(Bus* bus, uint8_t address, const uint8_t* tx, uint8_t txLen,
+                         uint8_t* rx, uint8_t rxLen, bool first, bool last) {
+        uint8_t addressRW = address << 1 | (txLen || !rxLen ? I2C_WRITE : I2C_READ);
+        bool ack = first ? start(bus, addressRW) : restart(bus, addressRW);
+        while (ack && txLen) {
+            ack = write(bus, *tx++);
+            txLen--;
+        }
+        if (ack && rxLen && !(addressRW & I2C_READ)) {
+            ack = restart(bus, address << 1 | I2C_READ);
+        }
+        while (ack && rxLen) {
+            rxLen--;
+            *rx++ = read(bus, rxLen == 0);
+        }
+        if (!ack || last) {
+            stop(bus);
+        }
+        return ack;
+    }
+};
+
+/** Any I2cMasterBase, known only at run time: virtual calls */
+template <>
+struct MLX90615BusOps<I2cMasterBase> {
+    static bool start(I2cMasterBase* bus, uint8_t addressRW) {
+        return bus->start(addressRW);
+    }
+    static bool restart(I2cMasterBase* bus, uint8_t addressRW) {
+        return bus->restart(addressRW);
+    }
+    static bool write(I2cMasterBase* bus, uint8_t data) {
+        return bus->write(data);
+    }
+    static uint8_t read(I2cMasterBase* bus, uint8_t last) {
+        return bus->read(last);
+    }
+    static void stop(I2cMasterBase* bus) {
+        bus->stop();
+    }
+    static void holdScl(I2cMasterBase* bus, bool low) {
+        bus->holdScl(low);
+    }
+    static bool recover(I2cMasterBase* bus) {
+        return bus->recover();
+    }
+    static bool transfer(I2cMasterBase* bus, uint8_t address, const uint8_t* tx, uint8_t txLen,
+                         uint8_t* rx, uint8_t rxLen, bool first, bool last) {
+        return bus->transfer(address, tx, txLen, rx, rxLen, first, last);
+    }
+};
+
+#if !defined(ARDUINO_ARCH_AVR)
+/** TwiMaster on Wire: whole messages, one burst per transfer */
+template <>
+struct MLX90615BusOps<TwiMaster> {
+    static void stop(TwiMaster* bus) {
+        bus->TwiMaster::stop();
+    }
+    static void holdScl(TwiMaster* bus, bool low) {
+        bus->TwiMaster::holdScl(low);
+    }
+    static bool recover(TwiMaster* bus) {
+        return bus->TwiMaster::recover();
+    }
+    static bool transfer(TwiMaster* bus, uint8_t address, const uint8_t* tx, uint8_t txLen,
+                         uint8_t* rx, uint8_t rxLen, bool first, bool last) {
+        return bus->TwiMaster::transfer(address, tx, txLen, rx, rxLen, first, last);
+    }
+};
+#endif  // ARDUINO_ARCH_AVR
+
+/**
+    Transport over the included I2C library (SoftI2cMaster, TwiMaster, or
+    any other I2cMasterBase implementation)
+*/
+template <class Bus>
+class MLX90615BusTransport {
+
+  protected:
+    typedef MLX90615BusOps<Bus> Ops;
+    Bus* bus;
+
+  public:
+
+    explicit MLX90615BusTransport(Bus* i2c) : bus(i2c) {}
+
+    int readWord(uint8_t dev, uint8_t cmd, uint8_t* data, bool first, bool last) {
+        return Ops::transfer(bus, dev >> 1, &cmd, 1, data, 3, first, last) ? 0 : -2;
+    }
+
+    void release(uint8_t dev) {
+        (void)dev;
+        Ops::stop(bus);
+    }
+
+    int writeBytes(uint8_t dev, const uint8_t* data, uint8_t len) {
+        return Ops::transfer(bus, dev >> 1, data, len, 0, 0, true, true) ? 0 : -2;
+    }
+
+    void holdScl(bool low) {
+        Ops::holdScl(bus, low);
+    }
+
+    bool recover() {
+        return Ops::recover(bus);
+    }
+};
+
+typedef MLX90615BusTransport<SoftI2cMaster> MLX90615SoftI2cTransport;
+typedef MLX90615BusTransport<TwiMaster> MLX90615TwiTransport;
+
+/**
+    Wire or I2cMasterBase chosen at run time, as used by class MLX90615
+*/
+class MLX90615AnyTransport {
+
+  protected:
+    TwoWire* wbus;
+    I2cMasterBase* bus;
+
+  public:
+
+    explicit MLX90615AnyTransport(TwoWire* i2c) : wbus(i2c), bus(0) {}
+
+    explicit MLX90615AnyTransport(I2cMasterBase* i2c) : wbus(0), bus(i2c) {}
+
+    TwoWire* getWire() {
+        return wbus;
+    }
+
+    I2cMasterBase* getBus() {
+        return bus;
+    }
+
+    int readWord(uint8_t dev, uint8_t cmd, uint8_t* data, bool first, bool last) {
+        if (bus && !wbus) {
+            // Using alternative I2C library
+            return MLX90615BusTransport<I2cMasterBase>(bus).readWord(dev, cmd, data, first, last);
+        } else if (wbus && !bus) {
+            // Using Wire
+            return MLX90615WireTransport(wbus).readWord(dev, cmd, data, first, last);
+        }
+        return -10;
+    }
+
+    void release(uint8_t dev) {
+        if (bus && !wbus) {
+            bus->stop();
+        } else if (wbus && !bus) {
+            MLX90615WireTransport(wbus).release(dev);
+        }
+    }
+
+    int writeBytes(uint8_t dev, const uint8_t* data, uint8_t len) {
+        if (bus && !wbus) {
+            return MLX90615BusTransport<I2cMasterBase>(bus).writeBytes(dev, data, len);
+        } else if (wbus && !bus) {
+            return MLX90615WireTransport(wbus).writeBytes(dev, data, len);
+        }
+        return -10;
+    }
+
+    void holdScl(bool low) {
+        if (bus && !wbus) {
+            bus->holdScl(low);
+        } else if (wbus && !bus) {
+            MLX90615WireTransport(wbus).holdScl(low);
+        }
+    }
+
+    bool recover() {
+        if (bus && !wbus) {
+            return bus->recover();
+        } else if (wbus && !bus) {
+            return MLX90615WireTransport(wbus).recover();
+        }
+        return false;
+    }
+};
+
+/**
+    One register read or write, as a plain descriptor: it lives wherever
+    the caller puts it (stack, static pool), is filled by mlx90615Read()
+    or mlx90615Write() and completed in place by mlx90615Submit(). The
+    driver keeps no per-transfer state of its own.
+*/
+struct MLX90615Transaction {
+    uint8_t dev;        // 8-bit address; bit 0: I2C_READ or I2C_WRITE
+    uint8_t frame[4];   // cmd, lsb, msb, pec (received for a read)
+    int8_t status;      // I2C_PENDING, else as MLX90615::readReg()
+};
+
+/** Prepare a register read */
+inline void mlx90615Read(MLX90615Transaction* t, uint8_t addr, uint8_t cmd) {
+    t->dev = addr << 1 | I2C_READ;
+    t->frame[0] = cmd;
+    t->status = I2C_PENDING;
+}
+
+/** Prepare a register write, PEC included */
+inline void mlx90615Write(MLX90615Transaction* t, uint8_t addr, uint8_t cmd, uint16_t value) {
+    uint8_t pecFrame[4] = {(uint8_t)(addr << 1), cmd, (uint8_t)(value & 0xff), (uint8_t)(value >> 8)};
+    t->dev = addr << 1 | I2C_WRITE;
+    t->frame[0] = cmd;
+    t->frame[1] = pecFrame[2];
+    t->frame[2] = pecFrame[3];
+    t->frame[3] = mlx90615Crc8(0x00, pecFrame, 4);
+    t->status = I2C_PENDING;
+}
+
+/** Register value of a completed read (status 0) */
+inline uint16_t mlx90615Value(const MLX90615Transaction* t) {
+    return (uint16_t)t->frame[2] << 8 | t->frame[1];
+}
+
+/**
+    Run one transaction, as part of a bus session for a read
+    @param first, last: As the transport readWord(); ignored for a write
+    @return: status, also stored in the transaction
+*/
+template <class Transport>
+int mlx90615Execute(Transport& transport, MLX90615Transaction* t, bool first, bool last) {
+    uint8_t dev = t->dev & ~I2C_READ;
+    int status;
+    if (!(t->dev & I2C_READ)) {
+        status = transport.writeBytes(dev, t->frame, 4);
+    } else if (!(status = transport.readWord(dev, t->frame[0], &t->frame[1], first, last))) {
+        uint8_t pecFrame[5] = {dev, t->frame[0], (uint8_t)(dev | I2C_READ), t->frame[1], t->frame[2]};
+        if (mlx90615Crc8(0x00, pecFrame, 5) != t->frame[3]) {
+            if (!last) {
+                transport.release(dev);
+            }
+            status = -1;
+        }
+    }
+    t->status = status;
+    return status;
+}
+
+/**
+    Run a list of transactions, completed in place. Consecutive reads,
+    whatever their device, share one bus session (one start, repeated
+    starts, one stop); each write is a session of its own. Not retried.
+    @return: 0 if all succeeded, else the status of the last failure
+*/
+template <class Transport>
+int mlx90615Submit(Transport& transport, MLX90615Transaction* list, uint8_t count) {
+    int result = 0;
+    bool open = false;
+    for (uint8_t i = 0; i < count; i++) {
+        MLX90615Transaction* t = &list[i];
+        bool last = i == count - 1 || !(list[i + 1].dev & I2C_READ);
+        int status = mlx90615Execute(transport, t, !open, last);
+        // A failed read closed the session
+        open = (t->dev & I2C_READ) && !last && !status;
+        if (status) {
+            result = status;
+        }
+    }
+    return result;
+}
+
+#endif // __MLX90615_TRANSPORT_H__
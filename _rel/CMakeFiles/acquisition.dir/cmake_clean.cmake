@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/acquisition.dir/extras/host/sketch.cpp.o"
+  "CMakeFiles/acquisition.dir/extras/host/sketch.cpp.o.d"
+  "acquisition"
+  "acquisition.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/acquisition.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
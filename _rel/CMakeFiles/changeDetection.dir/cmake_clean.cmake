@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/changeDetection.dir/extras/host/sketch.cpp.o"
+  "CMakeFiles/changeDetection.dir/extras/host/sketch.cpp.o.d"
+  "changeDetection"
+  "changeDetection.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/changeDetection.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
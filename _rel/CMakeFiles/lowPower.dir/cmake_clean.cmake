@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lowPower.dir/extras/host/sketch.cpp.o"
+  "CMakeFiles/lowPower.dir/extras/host/sketch.cpp.o.d"
+  "lowPower"
+  "lowPower.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/lowPower.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/I2cMaster.cpp" "CMakeFiles/mlx90615.dir/I2cMaster.cpp.o" "gcc" "CMakeFiles/mlx90615.dir/I2cMaster.cpp.o.d"
+  "/root/repo/extras/host/Arduino.cpp" "CMakeFiles/mlx90615.dir/extras/host/Arduino.cpp.o" "gcc" "CMakeFiles/mlx90615.dir/extras/host/Arduino.cpp.o.d"
+  "/root/repo/extras/host/Wire.cpp" "CMakeFiles/mlx90615.dir/extras/host/Wire.cpp.o" "gcc" "CMakeFiles/mlx90615.dir/extras/host/Wire.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
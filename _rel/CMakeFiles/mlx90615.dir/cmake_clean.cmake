@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mlx90615.dir/I2cMaster.cpp.o"
+  "CMakeFiles/mlx90615.dir/I2cMaster.cpp.o.d"
+  "CMakeFiles/mlx90615.dir/extras/host/Arduino.cpp.o"
+  "CMakeFiles/mlx90615.dir/extras/host/Arduino.cpp.o.d"
+  "CMakeFiles/mlx90615.dir/extras/host/Wire.cpp.o"
+  "CMakeFiles/mlx90615.dir/extras/host/Wire.cpp.o.d"
+  "libmlx90615.a"
+  "libmlx90615.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/mlx90615.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libmlx90615.a"
+)
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/multiBus.dir/extras/host/sketch.cpp.o"
+  "CMakeFiles/multiBus.dir/extras/host/sketch.cpp.o.d"
+  "multiBus"
+  "multiBus.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/multiBus.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/multiDevice.dir/extras/host/sketch.cpp.o"
+  "CMakeFiles/multiDevice.dir/extras/host/sketch.cpp.o.d"
+  "multiDevice"
+  "multiDevice.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/multiDevice.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
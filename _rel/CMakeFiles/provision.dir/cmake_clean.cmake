@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/provision.dir/extras/host/sketch.cpp.o"
+  "CMakeFiles/provision.dir/extras/host/sketch.cpp.o.d"
+  "provision"
+  "provision.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/provision.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
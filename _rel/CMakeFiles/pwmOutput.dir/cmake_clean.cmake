@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pwmOutput.dir/extras/host/sketch.cpp.o"
+  "CMakeFiles/pwmOutput.dir/extras/host/sketch.cpp.o.d"
+  "pwmOutput"
+  "pwmOutput.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pwmOutput.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
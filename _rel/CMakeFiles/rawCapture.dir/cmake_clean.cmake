@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/rawCapture.dir/extras/host/sketch.cpp.o"
+  "CMakeFiles/rawCapture.dir/extras/host/sketch.cpp.o.d"
+  "rawCapture"
+  "rawCapture.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/rawCapture.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
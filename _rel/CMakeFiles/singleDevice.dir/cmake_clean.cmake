@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/singleDevice.dir/extras/host/sketch.cpp.o"
+  "CMakeFiles/singleDevice.dir/extras/host/sketch.cpp.o.d"
+  "singleDevice"
+  "singleDevice.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/singleDevice.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_array.dir/extras/test/test_array.cpp.o"
+  "CMakeFiles/test_array.dir/extras/test/test_array.cpp.o.d"
+  "test_array"
+  "test_array.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_array.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_bus.dir/extras/test/test_bus.cpp.o"
+  "CMakeFiles/test_bus.dir/extras/test/test_bus.cpp.o.d"
+  "test_bus"
+  "test_bus.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_bus.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
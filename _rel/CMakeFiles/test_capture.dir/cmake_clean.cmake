@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_capture.dir/extras/test/test_capture.cpp.o"
+  "CMakeFiles/test_capture.dir/extras/test/test_capture.cpp.o.d"
+  "test_capture"
+  "test_capture.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_capture.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_crc.dir/extras/test/test_crc.cpp.o"
+  "CMakeFiles/test_crc.dir/extras/test/test_crc.cpp.o.d"
+  "test_crc"
+  "test_crc.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_crc.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_deadband.dir/extras/test/test_deadband.cpp.o"
+  "CMakeFiles/test_deadband.dir/extras/test/test_deadband.cpp.o.d"
+  "test_deadband"
+  "test_deadband.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_deadband.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
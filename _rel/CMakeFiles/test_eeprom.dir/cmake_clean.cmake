@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_eeprom.dir/extras/test/test_eeprom.cpp.o"
+  "CMakeFiles/test_eeprom.dir/extras/test/test_eeprom.cpp.o.d"
+  "test_eeprom"
+  "test_eeprom.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_eeprom.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
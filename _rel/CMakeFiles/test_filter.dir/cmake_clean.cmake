@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_filter.dir/extras/test/test_filter.cpp.o"
+  "CMakeFiles/test_filter.dir/extras/test/test_filter.cpp.o.d"
+  "test_filter"
+  "test_filter.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_filter.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
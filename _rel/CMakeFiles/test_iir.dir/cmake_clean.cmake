@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_iir.dir/extras/test/test_iir.cpp.o"
+  "CMakeFiles/test_iir.dir/extras/test/test_iir.cpp.o.d"
+  "test_iir"
+  "test_iir.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_iir.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
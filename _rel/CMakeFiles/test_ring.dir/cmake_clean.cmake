@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_ring.dir/extras/test/test_ring.cpp.o"
+  "CMakeFiles/test_ring.dir/extras/test/test_ring.cpp.o.d"
+  "test_ring"
+  "test_ring.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_ring.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_soft.dir/extras/test/test_soft.cpp.o"
+  "CMakeFiles/test_soft.dir/extras/test/test_soft.cpp.o.d"
+  "test_soft"
+  "test_soft.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_soft.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,44 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_rel
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(test_array "/root/repo/_rel/test_array")
+set_tests_properties(test_array PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_bus "/root/repo/_rel/test_bus")
+set_tests_properties(test_bus PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_calibration "/root/repo/_rel/test_calibration")
+set_tests_properties(test_calibration PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_capture "/root/repo/_rel/test_capture")
+set_tests_properties(test_capture PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_convert "/root/repo/_rel/test_convert")
+set_tests_properties(test_convert PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_crc "/root/repo/_rel/test_crc")
+set_tests_properties(test_crc PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_deadband "/root/repo/_rel/test_deadband")
+set_tests_properties(test_deadband PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_eeprom "/root/repo/_rel/test_eeprom")
+set_tests_properties(test_eeprom PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_filter "/root/repo/_rel/test_filter")
+set_tests_properties(test_filter PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_iir "/root/repo/_rel/test_iir")
+set_tests_properties(test_iir PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_multi "/root/repo/_rel/test_multi")
+set_tests_properties(test_multi PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_output "/root/repo/_rel/test_output")
+set_tests_properties(test_output PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_power "/root/repo/_rel/test_power")
+set_tests_properties(test_power PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_ring "/root/repo/_rel/test_ring")
+set_tests_properties(test_ring PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_scan "/root/repo/_rel/test_scan")
+set_tests_properties(test_scan PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_soft "/root/repo/_rel/test_soft")
+set_tests_properties(test_soft PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_telemetry "/root/repo/_rel/test_telemetry")
+set_tests_properties(test_telemetry PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_wire "/root/repo/_rel/test_wire")
+set_tests_properties(test_wire PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;31;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(benchmark "/root/repo/_rel/benchmark")
+set_tests_properties(benchmark PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;44;add_test;/root/repo/CMakeLists.txt;0;")
@@ -0,0 +1,82 @@
+/**
+    Sampling decoupled from the consumer: a timer interrupt reads the
+    sensors at a fixed rate into a MLX90615Ring, and loop() drains the
+    ring in batches, however long its Serial prints take. Samples the
+    consumer is too late for are counted as overruns, never waited for.
+
+    The interrupt uses a software I2C master: Wire needs interrupts itself
+    on AVR and can't be used from an ISR. On boards without Timer1 the
+    acquisition falls back to being serviced from loop().
+*/
+
+#include "MLX90615.h"
+#include "MLX90615Ring.h"
+
+#define SDA_PIN SDA
+#define SCL_PIN SCL
+#define SAMPLE_RATE 20 // Reads per second, over all channels
+
+FastSoftI2cMaster i2c(SDA_PIN, SCL_PIN);
+MLX90615 mlx90615(MLX90615_DefaultAddr, &i2c);
+
+// 2 channels, 32 samples of buffering
+MLX90615Acquisition<2, 32> acquisition;
+
+#if defined(TIMER1_COMPA_vect)
+ISR(TIMER1_COMPA_vect) {
+    acquisition.service();
+}
+
+void startTimer() {
+    noInterrupts();
+    TCCR1A = 0;
+    TCCR1B = _BV(WGM12) | _BV(CS12); // CTC, clk/256
+    TCNT1 = 0;
+    OCR1A = F_CPU / 256 / SAMPLE_RATE - 1;
+    TIMSK1 = _BV(OCIE1A);
+    interrupts();
+}
+#else
+uint32_t due;
+
+void startTimer() {
+    due = micros();
+}
+#endif
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial); // Only for native USB serial
+    delay(2000); // Additional delay to allow open the terminal to see setup() messages
+    Serial.println("Setup...");
+
+    acquisition.add(&mlx90615, MLX90615_OBJECT_TEMPERATURE);
+    acquisition.add(&mlx90615, MLX90615_AMBIENT_TEMPERATURE);
+    startTimer();
+}
+
+void loop() {
+    #if !defined(TIMER1_COMPA_vect)
+    if ((int32_t)(micros() - due) >= 0) {
+        due += 1000000UL / SAMPLE_RATE;
+        acquisition.service();
+    }
+    #endif
+
+    MLX90615Sample batch[8];
+    uint8_t n = acquisition.ring.drain(batch, 8);
+    for (uint8_t i = 0; i < n; i++) {
+        Serial.print(batch[i].timestamp);
+        Serial.print(batch[i].reg == MLX90615_OBJECT_TEMPERATURE ? " Object: " : " Ambient: ");
+        if (batch[i].status == 0) {
+            Serial.print(MLX90615::rawToInt<MLX90615_CENTI_CELSIUS>(batch[i].value) / 100.0);
+            Serial.println("°C");
+        } else {
+            Serial.println("error");
+        }
+    }
+    if (n) {
+        Serial.print("Overruns: ");
+        Serial.println(acquisition.ring.getOverruns());
+    }
+}
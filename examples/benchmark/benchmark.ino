@@ -0,0 +1,915 @@
+/**
+    Bus cost of the driver, measured against simulated MLX90615 devices.
+
+    No sensor needs to be connected: SimI2cMaster counts transactions,
+    bytes and SCL cycles for every call, so a change in the driver shows
+    up here as a change in numbers. Bus time is reported for 100 kHz and
+    400 kHz SCL. Correctness is checked by the host tests (extras/test),
+    not here.
+*/
+
+#include "MLX90615.h"
+#include "MLX90615Sim.h"
+#include "MLX90615Array.h"
+#include "MLX90615Ring.h"
+#include "MLX90615Filter.h"
+#include "MLX90615Deadband.h"
+#include "MLX90615Telemetry.h"
+#include "MLX90615Power.h"
+#include "MLX90615Eeprom.h"
+#include "MLX90615Scan.h"
+#include "MLX90615Calibration.h"
+#include "MLX90615Capture.h"
+#include "MLX90615Output.h"
+#include "MLX90615Iir.h"
+
+SimI2cMaster simBus;
+MLX90615Sim simDevice(MLX90615_DefaultAddr);
+MLX90615 mlx90615(MLX90615_DefaultAddr, &simBus);
+MLX90615T<MLX90615SimTransport> mlx90615T(MLX90615_DefaultAddr, &simBus);
+
+I2cBusStats before;
+
+uint32_t simMicros() {
+    return simBus.micros();
+}
+
+// Provisioning jig: one new device at a time
+SimI2cMaster jigBus;
+
+// Blocking EEPROM waits spin on the clock: let simulated time pass
+uint32_t jigMicros() {
+    jigBus.advance(100);
+    return jigBus.micros();
+}
+
+// The 3 more devices of the multi-device benchmarks
+MLX90615Sim simDevices[3] = {MLX90615Sim(0x5C), MLX90615Sim(0x5D), MLX90615Sim(0x5E)};
+MLX90615 devices[3] = {MLX90615(0x5C, &simBus), MLX90615(0x5D, &simBus), MLX90615(0x5E, &simBus)};
+MLX90615* all[4] = {&mlx90615, &devices[0], &devices[1], &devices[2]};
+
+// Non-blocking engine over the simulated bus
+I2cAsync engine(&simBus);
+
+void begin() {
+    before = simBus.stats();
+}
+
+void report(const char* name, uint16_t calls) {
+    I2cBusStats d = simBus.stats() - before;
+
+    Serial.print(name);
+    Serial.print(": ");
+    Serial.print((float)d.transactions / calls);
+    Serial.print(" transactions, ");
+    Serial.print((float)d.restarts / calls);
+    Serial.print(" restarts, ");
+    Serial.print((float)d.bytes / calls);
+    Serial.print(" bytes, ");
+    Serial.print((float)d.sclCycles / calls);
+    Serial.print(" SCL cycles, ");
+    Serial.print((float)d.sclCycles * 10.0 / calls);
+    Serial.print(" us @100kHz, ");
+    Serial.print((float)d.sclCycles * 2.5 / calls);
+    Serial.println(" us @400kHz");
+}
+
+#define CALLS 100
+
+// CPU time of one CRC-8 implementation over a read word frame
+void benchCrc(const char* name, uint8_t (*crc8)(uint8_t, const uint8_t*, int)) {
+    uint8_t frame[5] = {MLX90615_DefaultAddr << 1, MLX90615_OBJECT_TEMPERATURE,
+                        MLX90615_DefaultAddr << 1 | 1, 0x5a, 0x3a
+                       };
+    volatile uint8_t sink = 0;
+    uint32_t t0 = micros();
+    for (int i = 0; i < 1000; i++) {
+        frame[3] = i;
+        sink += crc8(0, frame, 5);
+    }
+    uint32_t t1 = micros();
+    Serial.print(name);
+    Serial.print(": ");
+    Serial.print((float)(t1 - t0) / 1000);
+    Serial.println(" us per 5 byte PEC");
+}
+
+// The conversion getTemperature used before the integer path
+float floatConversion(uint16_t tempData, bool fahrenheit) {
+    double tempFactor = 0.02;
+    float celsius = ((float)tempData * tempFactor) - 0.01;
+    celsius = (float)(celsius - 273.15);
+    return fahrenheit ? (celsius * 1.8) + 32.0 : celsius;
+}
+
+// CPU time of raw to temperature conversions, float vs integer
+void benchConversion() {
+    volatile float sinkFloat = 0;
+    volatile int32_t sinkInt = 0;
+    volatile uint16_t raw = 15500;
+    int32_t maxError = 0;
+
+    uint32_t t0 = micros();
+    for (int i = 0; i < 1000; i++) {
+        sinkFloat = floatConversion(raw + i, true);
+    }
+    uint32_t t1 = micros();
+    for (int i = 0; i < 1000; i++) {
+        sinkInt = MLX90615::rawToInt<MLX90615_CENTI_FAHRENHEIT>(raw + i);
+    }
+    uint32_t t2 = micros();
+    for (int i = 0; i < 1000; i++) {
+        int32_t error = MLX90615::rawToInt<MLX90615_CENTI_FAHRENHEIT>(raw + i)
+                        - (int32_t)floor(floatConversion(raw + i, true) * 100 + 0.5);
+        if (error < 0) {
+            error = -error;
+        }
+        if (error > maxError) {
+            maxError = error;
+        }
+    }
+    (void)sinkFloat;
+    (void)sinkInt;
+
+    Serial.print("Fahrenheit conversion: float ");
+    Serial.print((float)(t1 - t0) / 1000);
+    Serial.print(" us, integer ");
+    Serial.print((float)(t2 - t1) / 1000);
+    Serial.print(" us, max difference ");
+    Serial.print(maxError);
+    Serial.println(" x 0.01 °F");
+}
+
+// RAM and CPU time per update of one filter, over noisy raw readings
+template <class Filter>
+void benchFilter(const char* name, Filter& filter) {
+    volatile uint16_t sink = 0;
+    uint32_t t0 = micros();
+    for (int i = 0; i < 1000; i++) {
+        // 36.6 °C with +-4 LSB noise and a spike every 100 samples
+        uint16_t raw = 15488 + (i * 7 % 9) - 4 + (i % 100 == 50 ? 500 : 0);
+        sink = filter.update(raw);
+    }
+    uint32_t t1 = micros();
+    (void)sink;
+    Serial.print(name);
+    Serial.print(": ");
+    Serial.print(sizeof(filter));
+    Serial.print(" bytes, ");
+    Serial.print((float)(t1 - t0) / 1000);
+    Serial.print(" us per update, output ");
+    Serial.print(filter.template temperature<MLX90615_CENTI_CELSIUS>() / 100.0);
+    Serial.println(" °C");
+}
+
+// Target materials: emissivity, gain, offset (°C), reflected (°C)
+const float materials[][4] = {
+    {0.95, 1.0, 0.0, MLX90615_REFLECTED_AMBIENT},
+    {0.60, 1.0, 0.0, 40.0},
+    {0.30, 1.02, -0.5, MLX90615_REFLECTED_AMBIENT},
+};
+const MLX90615Profile profiles[] = {
+    mlx90615Profile(0.95),
+    mlx90615Profile(0.60, 1.0, 0.0, 40.0),
+    mlx90615Profile(0.30, 1.02, -0.5),
+};
+
+// Float reference of MLX90615Compensator::compensate(), raw units
+float compensateFloat(const float* m, uint16_t object, uint16_t ambient) {
+    double to = object * 0.02, ta = ambient * 0.02;
+    double tr = m[3] < -273.0 ? ta : m[3] + 273.16;
+    double t4 = pow(tr, 4) + (pow(to, 4) - pow(ta, 4)) / m[0] + (pow(ta, 4) - pow(tr, 4)) / m[0];
+    if (t4 <= 0) {
+        return 0;
+    }
+    double raw = ((sqrt(sqrt(t4)) - 273.16) * m[1] + 273.16 + m[2]) * 50;
+    return raw < 0 ? 0 : raw;
+}
+
+// CPU time and accuracy of the fixed point correction, per profile
+void benchCompensation() {
+    volatile uint16_t sink = 0;
+    const uint16_t ambient = 14908;     // 25 °C
+    for (uint8_t p = 0; p < sizeof(profiles) / sizeof(profiles[0]); p++) {
+        float maxError = 0;
+        uint32_t t0 = micros();
+        for (uint16_t raw = 11658; raw < 21658; raw += 40) {   // -40 .. 160 °C
+            sink = MLX90615Compensator::compensate(&profiles[p], raw, ambient);
+        }
+        uint32_t t1 = micros();
+        for (uint16_t raw = 11658; raw < 21658; raw += 40) {
+            float error = MLX90615Compensator::compensate(&profiles[p], raw, ambient)
+                          - compensateFloat(materials[p], raw, ambient);
+            if (fabs(error) > maxError) {
+                maxError = fabs(error);
+            }
+        }
+        Serial.print("Compensation e=");
+        Serial.print(materials[p][0]);
+        Serial.print(": ");
+        Serial.print((float)(t1 - t0) / 250);
+        Serial.print(" us, max difference to float ");
+        Serial.print(maxError);
+        Serial.println(" LSB (0.02 K)");
+    }
+    (void)sink;
+}
+
+// Pins toggled by the software I2C bit time measurement (no device needed)
+#define BENCH_SDA_PIN SDA
+#define BENCH_SCL_PIN SCL
+
+// Effective SCL bit time of a software I2C master, from 10 byte writes
+float bitTime(I2cMasterBase* i2c) {
+    uint32_t t0 = micros();
+    for (int i = 0; i < 10; i++) {
+        i2c->write(0x55);
+    }
+    return (float)(micros() - t0) / (10 * 9);
+}
+
+void benchSoftI2c() {
+    SoftI2cMaster soft(BENCH_SDA_PIN, BENCH_SCL_PIN);
+    FastSoftI2cMaster fast100(BENCH_SDA_PIN, BENCH_SCL_PIN, 100000);
+    FastSoftI2cMaster fast400(BENCH_SDA_PIN, BENCH_SCL_PIN, 400000);
+
+    Serial.print("Software I2C bit time: SoftI2cMaster ");
+    Serial.print(bitTime(&soft));
+    Serial.print(" us, FastSoftI2cMaster@100kHz ");
+    Serial.print(bitTime(&fast100));
+    Serial.print(" us, FastSoftI2cMaster@400kHz ");
+    Serial.print(bitTime(&fast400));
+    Serial.println(" us");
+}
+
+// Bus traffic and CPU time of one register read
+void benchRead() {
+    uint16_t value;
+    begin();
+    for (int i = 0; i < CALLS; i++) {
+        mlx90615.readReg(MLX90615_OBJECT_TEMPERATURE, &value);
+    }
+    report("readReg", CALLS);
+
+    begin();
+    for (int i = 0; i < CALLS; i++) {
+        mlx90615.getTemperature(MLX90615_OBJECT_TEMPERATURE);
+    }
+    report("getTemperature", CALLS);
+
+    // Same bus traffic, transport bound at compile time
+    begin();
+    uint32_t t0 = micros();
+    for (int i = 0; i < CALLS; i++) {
+        mlx90615.readReg(MLX90615_OBJECT_TEMPERATURE, &value);
+    }
+    uint32_t t1 = micros();
+    for (int i = 0; i < CALLS; i++) {
+        mlx90615T.readReg(MLX90615_OBJECT_TEMPERATURE, &value);
+    }
+    uint32_t t2 = micros();
+    report("readReg MLX90615 + MLX90615T", 2 * CALLS);
+    Serial.print("CPU time per readReg: MLX90615 ");
+    Serial.print((float)(t1 - t0) / CALLS);
+    Serial.print(" us, MLX90615T<MLX90615SimTransport> ");
+    Serial.print((float)(t2 - t1) / CALLS);
+    Serial.println(" us");
+}
+
+// All three RAM registers one by one, then in one session
+void benchReadAll() {
+    uint16_t value;
+    begin();
+    for (int i = 0; i < CALLS; i++) {
+        mlx90615.readReg(MLX90615_RAW_IR_DATA, &value);
+        mlx90615.readReg(MLX90615_AMBIENT_TEMPERATURE, &value);
+        mlx90615.readReg(MLX90615_OBJECT_TEMPERATURE, &value);
+    }
+    report("readReg x3", CALLS);
+    uint32_t separate = simBus.stats().sclCycles - before.sclCycles;
+
+    MLX90615Data data;
+    begin();
+    for (int i = 0; i < CALLS; i++) {
+        mlx90615.readAll(&data);
+    }
+    report("readAll", CALLS);
+    uint32_t batched = simBus.stats().sclCycles - before.sclCycles;
+    Serial.print("readAll saving vs readReg x3: ");
+    Serial.print((float)((int32_t)separate - (int32_t)batched) * 10.0 / CALLS);
+    Serial.println(" us/call @100kHz");
+}
+
+// EEPROM writes, the erases put back to the default emissivity
+void benchWrite() {
+    begin();
+    for (int i = 0; i < CALLS; i++) {
+        mlx90615.writeReg(MLX90615_EEPROM_EMISSIVITY, 0x0000);
+        simBus.advance(MLX90615_SIM_EEPROM_WRITE_US);
+    }
+    report("writeReg", CALLS);
+
+    mlx90615.writeReg(MLX90615_EEPROM_EMISSIVITY, Default_Emissivity);
+    simBus.advance(MLX90615_SIM_EEPROM_WRITE_US);
+}
+
+// Corrupted and unacknowledged frames are retried
+void benchRetry() {
+    uint16_t value;
+    mlx90615.resetStats();
+    simDevice.injectBadPec(1);
+    simDevice.injectNak(1);
+    begin();
+    int status = mlx90615.readReg(MLX90615_OBJECT_TEMPERATURE, &value);
+    report("readReg with 1 bad PEC + 1 Nak", 1);
+    MLX90615Stats errors = mlx90615.getStats();
+    Serial.print("  status ");
+    Serial.print(status);
+    Serial.print(", reads ");
+    Serial.print(errors.reads);
+    Serial.print(", crcErrors ");
+    Serial.print(errors.crcErrors);
+    Serial.print(", naks ");
+    Serial.print(errors.naks);
+    Serial.print(", retries ");
+    Serial.println(errors.retries);
+}
+
+// Round-robin scheduler over 4 devices at 200 reads/s (simulated time)
+void benchArray() {
+    MLX90615Array<4> sensors;
+    for (int i = 0; i < 4; i++) {
+        sensors.add(all[i]);
+    }
+    sensors.setClock(simMicros);
+    sensors.setRate(200);
+    uint32_t reads = 0;
+    while (reads < 4 * CALLS) {
+        if (sensors.poll() < 0) {
+            simBus.advance(7); // Other work in loop()
+        } else {
+            reads++;
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        Serial.print("MLX90615Array device ");
+        Serial.print(i);
+        Serial.print(": ");
+        Serial.print(sensors.rate(i));
+        Serial.print(" Hz, jitter ");
+        Serial.print(sensors.jitter(i));
+        Serial.println(" us");
+    }
+}
+
+// Same devices read through the non-blocking engine
+void benchAsync() {
+    uint16_t value;
+    MLX90615AsyncRead requests[4] = {};
+    for (int i = 0; i < 4; i++) {
+        all[i]->readRegAsync(&engine, MLX90615_OBJECT_TEMPERATURE, &requests[i]);
+    }
+    uint32_t polls = 0;
+    while (engine.poll()) {
+        polls++; // Other work would go here, between bus operations
+    }
+    Serial.print("I2cAsync: 4 reads in ");
+    Serial.print(polls);
+    Serial.print(" polls, ");
+    for (int i = 0; i < 4; i++) {
+        int status = MLX90615::readRegResult(&requests[i], &value);
+        Serial.print(status ? -1.0 : MLX90615::rawToTemperature(value));
+        Serial.print(i < 3 ? ", " : "\n");
+    }
+}
+
+// Same devices, all three registers, from a caller-owned descriptor pool
+void benchTransactions() {
+    MLX90615Data readAlls[4];
+    begin();
+    for (int i = 0; i < 4; i++) {
+        all[i]->readAll(&readAlls[i]);
+    }
+    report("readAll x 4 devices", 4);
+    MLX90615Transaction pool[12];
+    const uint8_t addresses[4] = {MLX90615_DefaultAddr, 0x5C, 0x5D, 0x5E};
+    for (int i = 0; i < 12; i++) {
+        mlx90615Read(&pool[i], addresses[i / 3], MLX90615_RAW_IR_DATA + i % 3);
+    }
+    begin();
+    int status = mlx90615.submit(pool, 12);
+    report("submit 12 MLX90615Transaction", 4);
+    Serial.print("MLX90615Transaction: ");
+    Serial.print(sizeof(MLX90615Transaction));
+    Serial.print(" bytes each, status ");
+    Serial.println(status);
+}
+
+// Producer ahead of a late consumer: 48 reads into a 32 sample ring
+void benchRing() {
+    MLX90615Acquisition<4, 32> acquisition;
+    for (int i = 0; i < 4; i++) {
+        acquisition.add(all[i]);
+    }
+    begin();
+    for (int i = 0; i < 48; i++) {
+        acquisition.service();
+    }
+    report("MLX90615Acquisition service", 48);
+    MLX90615Sample batch[16];
+    uint32_t drained = 0;
+    uint8_t n;
+    while ((n = acquisition.ring.drain(batch, 16)) > 0) {
+        drained += n;
+    }
+    // Same through the engine, one sample queued per completed read
+    uint32_t queued = 0;
+    while (queued < 8) {
+        queued += acquisition.serviceAsync(&engine);
+        engine.poll();
+    }
+    drained += acquisition.ring.drain(batch, 16);
+    Serial.print("MLX90615Ring: ");
+    Serial.print(drained);
+    Serial.print(" samples drained, ");
+    Serial.print(acquisition.ring.getOverruns());
+    Serial.println(" overruns");
+}
+
+// Stable target with +-2 LSB noise and a slow drift, 10 samples/s for 10 min
+void benchDeadband() {
+    MLX90615Data data;
+    MLX90615Deadband detector(&mlx90615);
+    uint16_t reports = 0;
+    for (uint16_t i = 0; i < 6000; i++) {
+        simDevice.setRaw(MLX90615_OBJECT_TEMPERATURE, 15488 + i / 600 + (i * 7 % 5) - 2);
+        if (mlx90615.readAll(&data) == 0 && detector.update(&data, simMicros() / 1000)) {
+            reports++;
+        }
+        simBus.advance(100000);
+    }
+    Serial.print("MLX90615Deadband: ");
+    Serial.print(reports);
+    Serial.println(" reports for 6000 samples");
+}
+
+// Telemetry frames of 4 devices (object + ambient) vs multiDevice's text
+void benchTelemetry() {
+    MLX90615TelemetryEncoder<4> encoder;
+    MLX90615TelemetryDecoder<4> decoder;
+    MLX90615Data samples[4];
+    MLX90615Data received[4] = {};
+    uint8_t frame[MLX90615_TELEMETRY_MAX_FRAME(8)];
+    uint32_t binaryBytes = 0;
+    uint32_t asciiBytes = 0;
+    uint16_t mismatches = 0;
+    uint16_t dropped = 0;
+    for (int i = 0; i < CALLS; i++) {
+        simDevice.setRaw(MLX90615_OBJECT_TEMPERATURE, 15488 + (i * 7 % 5) - 2 + i / 10);
+        uint8_t bitmap = 0;
+        for (int dev = 0; dev < 4; dev++) {
+            if (all[dev]->readAll(&samples[dev]) == 0) {
+                bitmap |= 1 << dev;
+            }
+            char line[48];
+            int32_t object = MLX90615::rawToInt<MLX90615_CENTI_CELSIUS>(samples[dev].object);
+            int32_t ambient = MLX90615::rawToInt<MLX90615_CENTI_CELSIUS>(samples[dev].ambient);
+            asciiBytes += snprintf(line, sizeof(line), "Temp_%d: %ld.%02ld°C  %ld.%02ld°C  \r\n", dev + 1,
+                                   (long)object / 100, (long)object % 100, (long)ambient / 100, (long)ambient % 100);
+        }
+        uint8_t len = encoder.encode(samples, bitmap, frame, sizeof(frame));
+        binaryBytes += len;
+        if (i == CALLS / 2) {
+            continue; // Lost on the link: the decoder waits for a keyframe
+        }
+        uint8_t present;
+        if (decoder.decode(frame, len, received, &present) < 0) {
+            dropped++;
+            continue;
+        }
+        for (int dev = 0; dev < 4; dev++) {
+            if (received[dev].object != samples[dev].object || received[dev].ambient != samples[dev].ambient) {
+                mismatches++;
+            }
+        }
+    }
+    Serial.print("MLX90615Telemetry: ");
+    Serial.print((float)binaryBytes / (8 * CALLS));
+    Serial.print(" bytes/sample vs ");
+    Serial.print((float)asciiBytes / (8 * CALLS));
+    Serial.print(" as text, ");
+    Serial.print(mismatches);
+    Serial.print(" mismatches, ");
+    Serial.print(decoder.getLost());
+    Serial.print(" lost + ");
+    Serial.print(dropped);
+    Serial.println(" frames until keyframe");
+}
+
+// Sleep between reads, one read every 2 s for 1 min (simulated time)
+void benchPower() {
+    MLX90615Data data;
+    MLX90615DutyCycle power(&mlx90615, 2000);
+    power.setClock(simMicros);
+    uint32_t powerStart = simMicros();
+    uint32_t awakeStart = simDevice.awakeTime(powerStart);
+    uint16_t powerSamples = 0;
+    uint16_t invalid = 0;
+    while (simMicros() - powerStart < 60000000UL) {
+        if (power.poll(&data) > 0) {
+            powerSamples++;
+            if (data.object == 0) {
+                invalid++;
+            }
+        }
+        simBus.advance(1000);
+    }
+    Serial.print("MLX90615DutyCycle: ");
+    Serial.print(powerSamples);
+    Serial.print(" samples (");
+    Serial.print(invalid);
+    Serial.print(" invalid), duty ");
+    Serial.print(power.duty() * 100);
+    Serial.print("% (simulated device ");
+    Serial.print((float)(simDevice.awakeTime(simMicros()) - awakeStart) * 100 / (simMicros() - powerStart));
+    Serial.print("%), worst latency ");
+    Serial.print(power.worstLatency());
+    Serial.println(" us");
+    // Wake up for the readings below
+    mlx90615.beginWake();
+    simBus.advance(MLX90615_WAKE_PULSE_MS * 1000UL);
+    mlx90615.endWake();
+    simBus.advance(MLX90615_WAKE_SETTLE_MS * 1000UL);
+}
+
+// Emissivity of 4 devices: one device after the other, then overlapped
+void benchEeprom() {
+    MLX90615Eeprom eeproms[4] = {MLX90615Eeprom(all[0]), MLX90615Eeprom(all[1]),
+                                 MLX90615Eeprom(all[2]), MLX90615Eeprom(all[3])
+                                };
+    MLX90615EepromBatch<4> eepromBatch;
+    for (int i = 0; i < 4; i++) {
+        eeproms[i].setClock(simMicros);
+        eeproms[i].load();
+        eepromBatch.add(&eeproms[i]);
+    }
+    uint32_t t0 = simMicros();
+    int status = 0;
+    for (int i = 0; i < 4; i++) {
+        eeproms[i].set(MLX90615_EEPROM_EMISSIVITY, 0x3d70); // 0.96
+        while ((status = eeproms[i].poll()) > 0) {
+            simBus.advance(100);
+        }
+    }
+    uint32_t t1 = simMicros();
+    for (int i = 0; i < 4; i++) {
+        eeproms[i].set(MLX90615_EEPROM_EMISSIVITY, Default_Emissivity);
+    }
+    while ((status = eepromBatch.poll()) > 0) {
+        simBus.advance(100);
+    }
+    uint32_t t3 = simMicros();
+    for (int i = 0; i < 4; i++) {
+        eeproms[i].set(MLX90615_EEPROM_EMISSIVITY, Default_Emissivity); // Unchanged
+    }
+    Serial.print("MLX90615Eeprom 4 devices: one by one ");
+    Serial.print((t1 - t0) / 1000.0);
+    Serial.print(" ms, batched ");
+    Serial.print((t3 - t1) / 1000.0);
+    Serial.print(" ms, status ");
+    Serial.print(status);
+    Serial.print(", ");
+    Serial.print(eeproms[0].getWrites() + eeproms[1].getWrites() + eeproms[2].getWrites() + eeproms[3].getWrites());
+    Serial.print(" cell writes, ");
+    Serial.print(eeproms[0].getSkipped() + eeproms[1].getSkipped() + eeproms[2].getSkipped() + eeproms[3].getSkipped());
+    Serial.println(" skipped");
+}
+
+// Discovery of the 4 devices: readReg on every address, then the scanner
+void benchScan() {
+    uint16_t value;
+    begin();
+    uint8_t n = 0;
+    for (uint8_t addr = MLX90615_SCAN_FIRST; addr <= MLX90615_SCAN_LAST; addr++) {
+        MLX90615 candidate(addr, &simBus);
+        if (candidate.readReg(MLX90615_EEPROM_SA, &value) == 0) {
+            n++;
+        }
+    }
+    report("Scan with readReg", 1);
+    MLX90615Scanner scanner(&simBus);
+    uint8_t found[8];
+    for (int quick = 0; quick <= 1; quick++) {
+        scanner.setQuickProbe(quick);
+        begin();
+        n = scanner.scan(found, 8);
+        report(quick ? "MLX90615Scanner with probe" : "MLX90615Scanner", 1);
+    }
+    Serial.print("  found ");
+    Serial.print(n);
+    Serial.print(":");
+    for (uint8_t i = 0; i < n && i < 8; i++) {
+        Serial.print(" 0x");
+        Serial.print(found[i], HEX);
+    }
+    Serial.println();
+}
+
+// 3 factory fresh devices provisioned one after the other
+void benchProvisioning() {
+    MLX90615Provisioner provisioner(&jigBus, 0x20, 0x2F);
+    provisioner.setClock(jigMicros);
+    for (int i = 0; i < 3; i++) {
+        MLX90615Sim fresh(MLX90615_DefaultAddr);
+        jigBus.attach(&fresh);
+        uint8_t assigned = 0;
+        int status = provisioner.present() ? provisioner.provisionNext(&assigned) : -2;
+        Serial.print("MLX90615Provisioner: status ");
+        Serial.print(status);
+        Serial.print(", 0x");
+        Serial.print(assigned, HEX);
+        Serial.print(", EEPROM 0x");
+        Serial.println(fresh.getEEPROM(MLX90615_EEPROM_SA), HEX);
+        jigBus.detach(&fresh);
+    }
+    // Several devices answering the general address at once are refused
+    MLX90615Provisioner crowded(&simBus, 0x20, 0x2F);
+    crowded.setClock(simMicros);
+    Serial.print("MLX90615Provisioner on a shared bus: status ");
+    Serial.println(crowded.provision(0x30));
+}
+
+// Retargeting a material: profile switch against an EEPROM emissivity rewrite
+void benchCalibration() {
+    benchCompensation();
+    MLX90615Compensator compensator(&mlx90615, &profiles[0]);
+    uint16_t corrected[3];
+    begin();
+    for (uint8_t p = 0; p < 3; p++) {
+        compensator.setProfile(&profiles[p]);
+        compensator.readObject(&corrected[p]);
+    }
+    report("MLX90615Compensator switch + readObject", 3);
+    MLX90615Eeprom emissivity(&mlx90615);
+    emissivity.setClock(simMicros);
+    emissivity.load();
+    uint32_t t0 = simMicros();
+    emissivity.set(MLX90615_EEPROM_EMISSIVITY, 0x3CCD);     // 0.95
+    int status;
+    while ((status = emissivity.poll()) > 0) {
+        simBus.advance(100);
+    }
+    uint32_t t1 = simMicros();
+    emissivity.set(MLX90615_EEPROM_EMISSIVITY, Default_Emissivity);
+    while (emissivity.poll() > 0) {
+        simBus.advance(100);
+    }
+    Serial.print("EEPROM emissivity rewrite: status ");
+    Serial.print(status);
+    Serial.print(", ");
+    Serial.print((t1 - t0) / 1000.0);
+    Serial.print(" ms; corrected object:");
+    for (uint8_t p = 0; p < 3; p++) {
+        Serial.print(" ");
+        Serial.print(MLX90615::rawToInt<MLX90615_CENTI_CELSIUS>(corrected[p]) / 100.0);
+    }
+    Serial.println(" °C");
+}
+
+// Raw IR capture: session length and decimation against samples per second
+void benchCapture() {
+    int16_t irSamples[64];
+    simDevice.setRaw(MLX90615_RAW_IR_DATA, 0x8123);     // -291
+    const uint8_t captures[][2] = {{1, 1}, {1, 8}, {1, 16}, {4, 16}};
+    for (uint8_t c = 0; c < 4; c++) {
+        MLX90615IrCapture ir(&mlx90615, captures[c][0], captures[c][1]);
+        ir.setClock(simMicros);
+        if (c == 3) {
+            simDevice.injectBadPec(2);
+        }
+        uint8_t n = ir.capture(irSamples, 64);
+        Serial.print("MLX90615IrCapture decimation ");
+        Serial.print(captures[c][0]);
+        Serial.print(", burst ");
+        Serial.print(captures[c][1]);
+        Serial.print(": ");
+        Serial.print(n);
+        Serial.print(" samples of ");
+        Serial.print(irSamples[n - 1]);
+        Serial.print(", ");
+        Serial.print(ir.sps());
+        Serial.print(" sps @100kHz, ");
+        Serial.print(ir.getDropped());
+        Serial.println(" dropped");
+    }
+    simDevice.setRaw(MLX90615_RAW_IR_DATA, 0);
+}
+
+// Bus recovery: a device cut off mid-read keeps SDA low for 5 more clocks
+void benchRecovery() {
+    uint16_t value;
+    MLX90615 nobody(0x5A, &simBus);
+    nobody.setRetries(0);
+    simDevices[0].injectStuckSda(5);
+    nobody.readReg(MLX90615_OBJECT_TEMPERATURE, &value);
+    uint32_t t0 = simMicros();
+    int status = mlx90615.recover();
+    uint32_t t1 = simMicros();
+    Serial.print("Bus recovery: status ");
+    Serial.print(status);
+    Serial.print(", ");
+    Serial.print(t1 - t0);
+    Serial.print(" us after a ");
+    Serial.print(I2C_TIMEOUT_USEC / 1000);
+    Serial.println(" ms timeout");
+}
+
+// Circuit breaker: one device gone, one stuck once; 2 s at 200 reads/s
+void benchBreaker() {
+    MLX90615Array<4> guarded;
+    for (int i = 0; i < 4; i++) {
+        guarded.add(all[i]);
+    }
+    guarded.setClock(simMicros);
+    guarded.setRate(200);
+    simBus.detach(&simDevices[2]);
+    simDevices[0].injectStuckSda(5);
+    uint32_t counts[4] = {};
+    uint32_t t0 = simMicros();
+    while (simMicros() - t0 < 2000000UL) {
+        int index = guarded.poll();
+        if (index < 0) {
+            simBus.advance(7);
+        } else if (guarded.channel(index)->status == 0) {
+            counts[index]++;
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        Serial.print("Breaker device ");
+        Serial.print(i);
+        Serial.print(": ");
+        Serial.print(counts[i] / 2.0);
+        Serial.print(" good reads/s, trips ");
+        Serial.print(guarded.channel(i)->trips);
+        Serial.println(guarded.tripped(i) ? ", tripped" : "");
+    }
+    simBus.attach(&simDevices[2]);
+}
+
+// PWM output: 20 .. 50 °C scale, then the duty of a 36.6 °C object timed back
+void benchOutput() {
+    uint16_t value = 0;
+    MLX90615Eeprom outputCells(&mlx90615);
+    outputCells.setClock(simMicros);
+    outputCells.load();
+    MLX90615Output output(&outputCells);
+    output.setMode(MLX90615_MODE_PWM);
+    output.setSource(true);
+    output.setScale<MLX90615_CENTI_CELSIUS>(2000, 5000);
+    int status;
+    while ((status = outputCells.poll()) > 0) {
+        simBus.advance(100);
+    }
+    uint16_t pwmMin = 0, pwmRange = 0;
+    int32_t scaleMin = 0, scaleMax = 0;
+    output.getRawScale(&pwmMin, &pwmRange);
+    output.getScale<MLX90615_CENTI_CELSIUS>(&scaleMin, &scaleMax);
+    MLX90615PwmReader pwm(pwmMin, pwmRange);
+    uint16_t object = MLX90615::intToRaw<MLX90615_CENTI_CELSIUS>(3660);
+    uint32_t highUs = pwmRange ? (uint32_t)(object - pwmMin) * 1024 / pwmRange : 0;
+    for (uint32_t edge = 0; edge < 4; edge++) {
+        pwm.edge(true, edge * 1024);
+        pwm.edge(false, edge * 1024 + highUs);
+    }
+    status = pwm.read(&value, 4 * 1024 - 1);
+    Serial.print("PWM output: ");
+    Serial.print(outputCells.getWrites());
+    Serial.print(" EEPROM writes, status ");
+    Serial.print(status);
+    Serial.print(", scale ");
+    Serial.print(scaleMin / 100.0);
+    Serial.print(" .. ");
+    Serial.print(scaleMax / 100.0);
+    Serial.print(" °C, SA 0x");
+    Serial.print(simDevice.getEEPROM(MLX90615_EEPROM_SA) & 0x7F, HEX);
+    Serial.print(", duty ");
+    Serial.print(pwm.duty() * 100.0 / 65536);
+    Serial.print("% -> ");
+    Serial.print(MLX90615::rawToInt<MLX90615_CENTI_CELSIUS>(value) / 100.0);
+    Serial.println(" °C");
+    output.setMode(MLX90615_MODE_SMBUS);
+    while (outputCells.poll() > 0) {
+        simBus.advance(100);
+    }
+}
+
+// IIR filter: settling time against noise, fastest setting for 0.1 K out of 0.25 K
+void benchIir() {
+    MLX90615Eeprom cells(&mlx90615);
+    cells.setClock(simMicros);
+    cells.load();
+    MLX90615Iir iir(&cells);
+    Serial.print("IIR settling/noise:");
+    for (uint8_t setting = 1; setting <= MLX90615_IIR_MAX; setting++) {
+        Serial.print(" ");
+        Serial.print(MLX90615Iir::settlingMs(setting));
+        Serial.print(" ms/");
+        Serial.print(MLX90615Iir::noise(setting, 0.25));
+        Serial.print(" K");
+    }
+    Serial.println();
+    uint8_t setting = MLX90615Iir::pick(0.25, 0.1);
+    iir.setIir(setting);
+    int status;
+    while ((status = cells.poll()) > 0) {
+        simBus.advance(100);
+    }
+    Serial.print("IIR setting ");
+    Serial.print(setting);
+    Serial.print(": status ");
+    Serial.print(status);
+    Serial.print(", CONFIG 0x");
+    Serial.println(simDevice.getEEPROM(MLX90615_EEPROM_CONFIG), HEX);
+}
+
+#if defined(I2C_INSTRUMENT)
+// Phase histograms over the simulated bus (build with -DI2C_INSTRUMENT)
+void benchInstrument() {
+    MLX90615Data data;
+    uint16_t value;
+    i2cInstrument.setClock(simMicros);
+    i2cInstrument.setWindow(100000);
+    i2cInstrument.reset();
+    for (int i = 0; i < CALLS; i++) {
+        mlx90615.readAll(&data);
+        simBus.advance(500);
+    }
+    MLX90615 absent(0x5A, &simBus);
+    absent.setRetries(0);
+    absent.readReg(MLX90615_OBJECT_TEMPERATURE, &value);
+    Serial.print("I2cInstrument utilization: ");
+    Serial.print(i2cInstrument.utilization());
+    Serial.println("%");
+    i2cInstrument.dump(Serial);
+}
+#endif
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial); // Only for native USB serial
+    delay(2000); // Additional delay to allow open the terminal to see setup() messages
+    Serial.println("Setup...");
+
+    benchCrc("CRC-8 bitwise", mlx90615Crc8Bitwise);
+    benchCrc("CRC-8 nibble table", mlx90615Crc8Nibble);
+    benchCrc("CRC-8 byte table", mlx90615Crc8Table);
+
+    benchConversion();
+
+    MLX90615MovingAverage<8> average;
+    MLX90615Ema<3> ema;
+    MLX90615Median<5> median;
+    benchFilter("MLX90615MovingAverage<8>", average);
+    benchFilter("MLX90615Ema<3>", ema);
+    benchFilter("MLX90615Median<5>", median);
+    benchSoftI2c();
+
+    simBus.attach(&simDevice);
+    simDevice.setTemperature(MLX90615_OBJECT_TEMPERATURE, 36.6);
+    simDevice.setTemperature(MLX90615_AMBIENT_TEMPERATURE, 22.5);
+    benchRead();
+    benchReadAll();
+    benchWrite();
+    benchRetry();
+
+    for (int i = 0; i < 3; i++) {
+        simBus.attach(&simDevices[i]);
+    }
+    benchArray();
+    benchAsync();
+    benchTransactions();
+    benchRing();
+    benchDeadband();
+    benchTelemetry();
+    benchPower();
+    benchEeprom();
+    benchScan();
+    benchProvisioning();
+    benchCalibration();
+    benchCapture();
+    benchRecovery();
+    benchBreaker();
+    benchOutput();
+    benchIir();
+    #if defined(I2C_INSTRUMENT)
+    benchInstrument();
+    #endif
+
+    Serial.print("Object temperature: ");
+    Serial.println(mlx90615.getTemperature(MLX90615_OBJECT_TEMPERATURE));
+    Serial.print("Ambient temperature: ");
+    Serial.println(mlx90615.getTemperature(MLX90615_AMBIENT_TEMPERATURE));
+}
+
+void loop() {
+}
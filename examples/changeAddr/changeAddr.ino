@@ -5,9 +5,11 @@
     anyother I2C device-- will answer to this address), then update
     the EEPROM address 0x00 (register 0x10) by clearing and setting
     the new address, and finally, addressing with this new I2C address
+    (the device only answers to it after a power cycle)
 */
 
 #include "MLX90615.h"
+#include "MLX90615Eeprom.h"
 
 /*
     Uncomment the following line to use included I2C library
@@ -42,15 +44,15 @@ void setup() {
 
     int result;
 
-    // 1. Change Addr
-    result = mlx90615.writeReg(MLX90615_EEPROM_SA, 0x0000); // Erase
-    Serial.println(result);
-    delay(10); // EEPROM Write/Erase time
-    result = mlx90615.writeReg(MLX90615_EEPROM_SA, CUSTOM_ADDR); // Write Custom Address
-    // result = mlx90615.writeReg(MLX90615_EEPROM_SA,MLX90615_DefaultAddr);
-    Serial.println(result);
-    delay(10); // EEPROM Write/Erase time
-    mlx90615.readEEPROM(MLX90615_EEPROM_SA); //read EEPROM data to check whether it's a default one.
+    // 1. Change Addr: erase, write and read back through the EEPROM manager
+    MLX90615Eeprom eeprom(&mlx90615);
+    result = eeprom.load();
+    if (!result) {
+        // Only the 7 address bits, and nothing is written if already set
+        eeprom.setBits(MLX90615_EEPROM_SA, 0x007F, CUSTOM_ADDR);
+        // eeprom.setBits(MLX90615_EEPROM_SA, 0x007F, MLX90615_DefaultAddr);
+        result = eeprom.commit();
+    }
     // Invoke the destructor
     mlx90615.~MLX90615();
 
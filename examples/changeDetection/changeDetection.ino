@@ -0,0 +1,42 @@
+/**
+    Print only meaningful changes: a reading is reported when the object
+    or ambient temperature moved by more than 0.1 °C since the last report,
+    or every minute as a heartbeat. On a stable target this prints a line
+    a minute instead of one a second.
+*/
+
+#include "MLX90615.h"
+#include "MLX90615Deadband.h"
+
+#define DEADBAND 5          // LSB, 0.02 °C each
+#define HEARTBEAT 60000     // ms
+
+MLX90615 mlx90615(MLX90615_DefaultAddr, &Wire);
+MLX90615Deadband detector(&mlx90615, DEADBAND, HEARTBEAT);
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial); // Only for native USB serial
+    delay(2000); // Additional delay to allow open the terminal to see setup() messages
+    Serial.println("Setup...");
+
+    Wire.begin();
+}
+
+void loop() {
+    MLX90615Data data;
+    int events = detector.poll(&data);
+
+    if (events < 0) {
+        Serial.println("error");
+    } else if (events) {
+        Serial.print(events & MLX90615_EVENT_HEARTBEAT ? "Heartbeat " : "Changed ");
+        Serial.print("Object: ");
+        Serial.print(MLX90615::rawToTemperature(data.object));
+        Serial.print("°C  Ambient: ");
+        Serial.print(MLX90615::rawToTemperature(data.ambient));
+        Serial.println("°C");
+    }
+
+    delay(100);
+}
@@ -0,0 +1,43 @@
+/**
+    Battery friendly sampling: the sensor sleeps between reads, one read
+    every 10 s. MLX90615DutyCycle wakes it up (SCL held low) ahead of each
+    read, waits for the data to settle, and puts it back to sleep.
+
+    Waking up drives SCL as a plain pin, which the included I2C library
+    does; with Wire, the board's default SCL pin is used.
+*/
+
+#include "MLX90615.h"
+#include "MLX90615Power.h"
+
+#define SDA_PIN SDA
+#define SCL_PIN SCL
+#define PERIOD_MS 10000
+
+SoftI2cMaster i2c(SDA_PIN, SCL_PIN);
+MLX90615 mlx90615(MLX90615_DefaultAddr, &i2c);
+MLX90615DutyCycle power(&mlx90615, PERIOD_MS);
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial); // Only for native USB serial
+    delay(2000); // Additional delay to allow open the terminal to see setup() messages
+    Serial.println("Setup...");
+
+    power.begin();
+}
+
+void loop() {
+    MLX90615Data data;
+    int status = power.poll(&data);
+
+    if (status < 0) {
+        Serial.println("error");
+    } else if (status) {
+        Serial.print("Object temperature: ");
+        Serial.print(MLX90615::rawToTemperature(data.object));
+        Serial.print("°C  Sensor awake ");
+        Serial.print(power.duty() * 100);
+        Serial.println("% of the time");
+    }
+}
@@ -0,0 +1,52 @@
+/**
+    Several MLX90615 with the same address, each one on its own SDA pin,
+    all sharing a single SCL pin. SoftI2cMultiMaster clocks the buses in
+    lockstep, so all sensors are read in the time of one.
+
+    On AVR, keep all SDA pins on the same port (e.g. pins 2..7 on an
+    ATmega328P, PORTD) to sample them with a single register read.
+*/
+
+#include "MLX90615.h"
+#include "MLX90615Multi.h"
+
+#define SCL_PIN 8
+#define SENSORS 3
+
+const uint8_t sdaPins[SENSORS] = {3, 5, 7};
+
+SoftI2cMultiMaster i2c(sdaPins, SENSORS, SCL_PIN);
+MLX90615Multi mlx90615(MLX90615_DefaultAddr, &i2c);
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial); // Only for native USB serial
+    delay(2000); // Additional delay to allow open the terminal to see setup() messages
+    Serial.println("Setup...");
+}
+
+void loop() {
+    int32_t objects[SENSORS];
+    int32_t ambients[SENSORS];
+
+    uint8_t okObj = mlx90615.getTemperatureInt<MLX90615_CENTI_CELSIUS>(MLX90615_OBJECT_TEMPERATURE, objects);
+    uint8_t okAmb = mlx90615.getTemperatureInt<MLX90615_CENTI_CELSIUS>(MLX90615_AMBIENT_TEMPERATURE, ambients);
+
+    for (uint8_t i = 0; i < SENSORS; i++) {
+        Serial.print("Temp_");
+        Serial.print(i + 1);
+        Serial.print(": ");
+        if (okObj & okAmb & (1 << i)) {
+            Serial.print(objects[i] / 100.0);
+            Serial.print("°C  ");
+            Serial.print(ambients[i] / 100.0);
+            Serial.println("°C  ");
+        } else {
+            Serial.println("error");
+        }
+    }
+
+    Serial.println("\n=======================================\n\r");
+
+    delay(1000);
+}
@@ -72,12 +72,18 @@ void setup() {
 }
 
 void loop() {
-    float temperatureObj1 = mlx90615_1.getTemperature(MLX90615_OBJECT_TEMPERATURE);
-    float temperatureObj2 = mlx90615_2.getTemperature(MLX90615_OBJECT_TEMPERATURE);
-    float temperatureObj3 = mlx90615_3.getTemperature(MLX90615_OBJECT_TEMPERATURE);
-    float temperatureAmb1 = mlx90615_1.getTemperature(MLX90615_AMBIENT_TEMPERATURE);
-    float temperatureAmb2 = mlx90615_2.getTemperature(MLX90615_AMBIENT_TEMPERATURE);
-    float temperatureAmb3 = mlx90615_3.getTemperature(MLX90615_AMBIENT_TEMPERATURE);
+    // One bus session per device for raw IR, ambient and object
+    MLX90615Data data1 = {}, data2 = {}, data3 = {};
+    mlx90615_1.readAll(&data1);
+    mlx90615_2.readAll(&data2);
+    mlx90615_3.readAll(&data3);
+
+    float temperatureObj1 = MLX90615::rawToTemperature(data1.object);
+    float temperatureObj2 = MLX90615::rawToTemperature(data2.object);
+    float temperatureObj3 = MLX90615::rawToTemperature(data3.object);
+    float temperatureAmb1 = MLX90615::rawToTemperature(data1.ambient);
+    float temperatureAmb2 = MLX90615::rawToTemperature(data2.ambient);
+    float temperatureAmb3 = MLX90615::rawToTemperature(data3.ambient);
 
     Serial.print("Temp_1: ");
     Serial.print(temperatureObj1);
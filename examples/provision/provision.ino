@@ -0,0 +1,59 @@
+/**
+    Provisioning jig: gives each MLX90615 plugged in a unique address,
+    starting at FIRST_ADDR. Connect one sensor at a time, wait for its
+    new address to be printed, unplug it and plug the next one.
+    Sensors use their new address after a power cycle.
+
+    Then, on the shared bus, the scan lists every sensor found.
+*/
+
+#include "MLX90615.h"
+#include "MLX90615Scan.h"
+
+#define FIRST_ADDR 0x20
+#define LAST_ADDR 0x3F
+
+MLX90615Provisioner provisioner(&Wire, FIRST_ADDR, LAST_ADDR);
+MLX90615Scanner scanner(&Wire);
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial); // Only for native USB serial
+    delay(2000); // Additional delay to allow open the terminal to see setup() messages
+    Serial.println("Setup...");
+
+    Wire.begin();
+
+    uint8_t found[16];
+    uint8_t count = scanner.scan(found, 16);
+    Serial.print("MLX90615 found:");
+    for (uint8_t i = 0; i < count && i < 16; i++) {
+        Serial.print(" 0x");
+        Serial.print(found[i], HEX);
+    }
+    Serial.println();
+    Serial.println("Connect a sensor to provision");
+}
+
+void loop() {
+    if (!provisioner.present()) {
+        delay(100);
+        return;
+    }
+
+    uint8_t addr;
+    int result = provisioner.provisionNext(&addr);
+    if (result) {
+        Serial.print("Error ");
+        Serial.println(result);
+    } else {
+        Serial.print("Address set to 0x");
+        Serial.println(addr, HEX);
+    }
+
+    Serial.println("Disconnect the sensor");
+    while (provisioner.present()) {
+        delay(100);
+    }
+    Serial.println("Connect a sensor to provision");
+}
@@ -0,0 +1,72 @@
+/**
+    Object temperature from the PWM output, without bus traffic: the
+    sensor drives its SDA pin with a duty cycle following the object
+    temperature, and a pin change interrupt times it.
+
+    Run once with CONFIGURE set: setup() switches the sensor to PWM output
+    with the scale below (EEPROM), then asks for a power cycle. SDA must be
+    on a pin with interrupt support.
+*/
+
+#include "MLX90615.h"
+#include "MLX90615Output.h"
+
+#define SDA_PIN 2
+#define SCL_PIN 3
+#define CONFIGURE 0
+#define SCALE_MIN 2000 // 0.01 °C
+#define SCALE_MAX 5000
+
+// As written by MLX90615Output::setScale(): the minimum moves by 2.56 K steps
+const uint16_t rawMin = MLX90615::intToRaw<MLX90615_CENTI_CELSIUS>(SCALE_MIN) &
+                        ~(MLX90615_PWMT_MIN_STEP - 1);
+const uint16_t rawRange = MLX90615::intToRaw<MLX90615_CENTI_CELSIUS>(SCALE_MAX) - rawMin;
+
+MLX90615PwmReader pwm(rawMin, rawRange);
+
+void onEdge() {
+    pwm.edge(digitalRead(SDA_PIN), micros());
+}
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial); // Only for native USB serial
+    delay(2000); // Additional delay to allow open the terminal to see setup() messages
+    Serial.println("Setup...");
+
+    #if CONFIGURE
+    SoftI2cMaster i2c(SDA_PIN, SCL_PIN);
+    MLX90615 mlx90615(MLX90615_DefaultAddr, &i2c);
+    MLX90615Eeprom cells(&mlx90615);
+    MLX90615Output output(&cells);
+    // SMBus until the next power cycle, whatever the current mode
+    mlx90615.wake();
+    int status = cells.load();
+    if (!status) {
+        output.setMode(MLX90615_MODE_PWM);
+        output.setSource(true);
+        output.setScale<MLX90615_CENTI_CELSIUS>(SCALE_MIN, SCALE_MAX);
+        status = cells.commit();
+    }
+    Serial.println(status ? "Configuration failed" : "Configured: power cycle the sensor");
+    #endif
+
+    // Leave SDA to the sensor
+    pinMode(SDA_PIN, INPUT);
+    pinMode(SCL_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(SDA_PIN), onEdge, CHANGE);
+}
+
+void loop() {
+    uint16_t raw;
+    if (pwm.read(&raw, micros()) == 0) {
+        Serial.print("Object: ");
+        Serial.print(MLX90615::rawToInt<MLX90615_CENTI_CELSIUS>(raw) / 100.0);
+        Serial.print("°C, duty ");
+        Serial.print(pwm.duty() * 100.0 / 65536);
+        Serial.println("%");
+    } else {
+        Serial.println("No PWM signal");
+    }
+    delay(500);
+}
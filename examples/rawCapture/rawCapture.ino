@@ -0,0 +1,55 @@
+/**
+    Capture the raw IR channel as fast as the bus allows, e.g. to catch
+    a fast-moving target. Each sample averages 4 reads, read in sessions
+    of 16; the achieved rate and the failed reads are printed after
+    each block.
+*/
+
+#include "MLX90615.h"
+#include "MLX90615Capture.h"
+
+#define SAMPLES 64
+#define DECIMATION 4
+#define BURST 16
+
+MLX90615 mlx90615(MLX90615_DefaultAddr, &Wire);
+MLX90615IrCapture capture(&mlx90615, DECIMATION, BURST);
+int16_t samples[SAMPLES];
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial); // Only for native USB serial
+    delay(2000); // Additional delay to allow open the terminal to see setup() messages
+    Serial.println("Setup...");
+
+    Wire.begin();
+    Wire.setClock(100000);
+}
+
+void loop() {
+    capture.reset();
+    uint16_t n = capture.capture(samples, SAMPLES);
+
+    int16_t low = 0x7FFF;
+    int16_t high = -0x7FFF;
+    for (uint16_t i = 0; i < n; i++) {
+        if (samples[i] < low) {
+            low = samples[i];
+        }
+        if (samples[i] > high) {
+            high = samples[i];
+        }
+    }
+    Serial.print(n);
+    Serial.print(" samples, raw IR ");
+    Serial.print(low);
+    Serial.print(" .. ");
+    Serial.print(high);
+    Serial.print(", ");
+    Serial.print(capture.sps());
+    Serial.print(" samples/s, ");
+    Serial.print(capture.getDropped());
+    Serial.println(" dropped");
+
+    delay(1000);
+}
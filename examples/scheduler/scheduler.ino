@@ -0,0 +1,68 @@
+/**
+    Several MLX90615 on a single bus (each one with an unique address,
+    see "changeAddr"), read round-robin by MLX90615Array instead of
+    sequential getTemperature() calls and delay().
+
+    loop() never blocks waiting for the next reading: poll() only
+    touches the bus when a slot is due.
+*/
+
+#include "MLX90615.h"
+#include "MLX90615Array.h"
+
+// TODO: Update with your real addresses and quantity of MLXs!
+#define DEVICE1_ADDR MLX90615_DefaultAddr
+#define DEVICE2_ADDR MLX90615_DefaultAddr+1
+#define DEVICE3_ADDR MLX90615_DefaultAddr+2
+
+// Reads per second, over all devices
+#define AGGREGATE_RATE 30
+
+MLX90615 mlx90615_1(DEVICE1_ADDR, &Wire);
+MLX90615 mlx90615_2(DEVICE2_ADDR, &Wire);
+MLX90615 mlx90615_3(DEVICE3_ADDR, &Wire);
+
+MLX90615Array<3> sensors;
+
+void setup() {
+    Serial.begin(9600);
+    while (!Serial); // Only for native USB serial
+    delay(2000); // Additional delay to allow open the terminal to see setup() messages
+    Serial.println("Setup...");
+
+    Wire.begin();
+
+    sensors.add(&mlx90615_1);
+    sensors.add(&mlx90615_2);
+    sensors.add(&mlx90615_3);
+    sensors.setRate(AGGREGATE_RATE);
+}
+
+void loop() {
+    int index = sensors.poll();
+    if (index < 0) {
+        return; // Nothing due: free for other work
+    }
+
+    MLX90615Channel* ch = sensors.channel(index);
+    if (ch->status) {
+        return;
+    }
+
+    // Print one device per second (the serial port is slower than the bus)
+    if (ch->samples % (AGGREGATE_RATE / sensors.size())) {
+        return;
+    }
+
+    Serial.print("Temp_");
+    Serial.print(index + 1);
+    Serial.print(": ");
+    Serial.print(MLX90615::rawToTemperature(ch->data.object));
+    Serial.print("°C  ");
+    Serial.print(MLX90615::rawToTemperature(ch->data.ambient));
+    Serial.print("°C  ");
+    Serial.print(sensors.rate(index));
+    Serial.print(" Hz, jitter ");
+    Serial.print(sensors.jitter(index));
+    Serial.println(" us");
+}
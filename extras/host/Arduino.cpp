@@ -0,0 +1,124 @@
+#include <Arduino.h>
+#include <time.h>
+
+HardwareSerial Serial;
+
+// Time passed in delay() and delayMicroseconds(), without sleeping
+static uint64_t skippedUs = 0;
+static bool realTime = true;
+
+static uint8_t modes[HOST_PINS];
+static uint8_t levels[HOST_PINS];
+static HostPins* attached = 0;
+
+static uint64_t monotonicUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint64_t hostUs(void) {
+    static uint64_t origin = monotonicUs();
+    return (realTime ? monotonicUs() - origin : 0) + skippedUs;
+}
+
+void hostRealTime(bool on) {
+    realTime = on;
+}
+
+uint32_t micros(void) {
+    return (uint32_t)hostUs();
+}
+
+uint32_t millis(void) {
+    return (uint32_t)(hostUs() / 1000);
+}
+
+void delay(uint32_t ms) {
+    skippedUs += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(uint32_t us) {
+    skippedUs += us;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < HOST_PINS) {
+        modes[pin] = mode;
+        // As on AVR: INPUT_PULLUP sets the output latch, OUTPUT keeps it
+        if (mode == INPUT_PULLUP) {
+            levels[pin] = HIGH;
+        }
+        if (attached) {
+            attached->changed(pin);
+        }
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    if (pin < HOST_PINS) {
+        levels[pin] = level ? HIGH : LOW;
+        if (attached) {
+            attached->changed(pin);
+        }
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    if (hostDrivesLow(pin) || (attached && attached->pullsLow(pin))) {
+        return LOW;
+    }
+    return HIGH;
+}
+
+void hostAttachPins(HostPins* pins) {
+    attached = pins;
+}
+
+uint8_t hostPinMode(uint8_t pin) {
+    return pin < HOST_PINS ? modes[pin] : INPUT;
+}
+
+bool hostDrivesLow(uint8_t pin) {
+    return pin < HOST_PINS && modes[pin] == OUTPUT && levels[pin] == LOW;
+}
+//------------------------------------------------------------------------------
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::print(long n, int base) {
+    if (n < 0 && base == DEC) {
+        return print('-') + print(0UL - (unsigned long)n, base);
+    }
+    return print((unsigned long)n, base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+    char buffer[8 * sizeof(long) + 1];
+    char* str = &buffer[sizeof(buffer) - 1];
+    *str = 0;
+    if (base < 2) {
+        base = DEC;
+    }
+    do {
+        char digit = n % base;
+        n /= base;
+        *--str = digit < 10 ? digit + '0' : digit + 'A' - 10;
+    } while (n);
+    return write(str);
+}
+
+size_t Print::print(double n, int digits) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, n);
+    return write(buffer);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return fputc(c, stdout) == EOF ? 0 : 1;
+}
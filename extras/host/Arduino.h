@@ -0,0 +1,162 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+/*
+    Host (Linux) stand-in for the Arduino core: just enough of the API to
+    build the library, its tests and the benchmark sketch with a native
+    compiler. Not a board: the pins are lines with pull-ups, low while the
+    sketch drives them low or something attached (HostPins) pulls them
+    low, and the time spent in delay()/delayMicroseconds() is added to the
+    clock instead of being slept.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define ARDUINO_ARCH_HOST
+
+typedef uint8_t byte;
+typedef uint16_t word;
+typedef bool boolean;
+
+#define HIGH            0x1
+#define LOW             0x0
+
+#define INPUT           0x0
+#define OUTPUT          0x1
+#define INPUT_PULLUP    0x2
+
+#define CHANGE          1
+#define FALLING         2
+#define RISING          3
+
+#define DEC             10
+#define HEX             16
+#define BIN             2
+
+#define PROGMEM
+#define pgm_read_byte(addr)     (*(const uint8_t*)(addr))
+#define F(string)               (string)
+
+static const uint8_t SDA = 18;
+static const uint8_t SCL = 19;
+#define PIN_WIRE_SDA    18
+#define PIN_WIRE_SCL    19
+
+#define HOST_PINS       64
+
+uint32_t micros(void);
+uint32_t millis(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+
+/**
+    Hardware on the pins, for tests (e.g. a simulated I2C slave): told of
+    every pinMode()/digitalWrite(), it can pull lines low.
+*/
+class HostPins {
+  public:
+    virtual ~HostPins() {}
+    /** The sketch changed the mode or level of pin */
+    virtual void changed(uint8_t pin) {
+        (void)pin;
+    }
+    /** \return true while the hardware pulls pin low */
+    virtual bool pullsLow(uint8_t pin) {
+        (void)pin;
+        return false;
+    }
+};
+
+/** Attach hardware to the pins, 0 for none */
+void hostAttachPins(HostPins* pins);
+/** \return last pinMode() of pin */
+uint8_t hostPinMode(uint8_t pin);
+/** \return true while the sketch drives pin low (OUTPUT, LOW) */
+bool hostDrivesLow(uint8_t pin);
+/** Run micros() on real time plus delays (default), or on delays only,
+    for exact timing in tests */
+void hostRealTime(bool on);
+
+inline void noInterrupts(void) {}
+inline void interrupts(void) {}
+
+#define digitalPinToInterrupt(pin)  (pin)
+inline void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode) {
+    (void)interrupt;
+    (void)isr;
+    (void)mode;
+}
+
+/**
+    Formatted output, as the core's Print: text, integers in any base and
+    floating point with a number of decimals.
+*/
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) {
+        return write((const uint8_t*)str, strlen(str));
+    }
+
+    size_t print(const char* str) {
+        return write(str);
+    }
+    size_t print(char c) {
+        return write((uint8_t)c);
+    }
+    size_t print(unsigned char n, int base = DEC) {
+        return print((unsigned long)n, base);
+    }
+    size_t print(int n, int base = DEC) {
+        return print((long)n, base);
+    }
+    size_t print(unsigned int n, int base = DEC) {
+        return print((unsigned long)n, base);
+    }
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(double n, int digits = 2);
+
+    size_t println(void) {
+        return write("\r\n");
+    }
+    template <class T>
+    size_t println(T value) {
+        size_t n = print(value);
+        return n + println();
+    }
+    template <class T>
+    size_t println(T value, int format) {
+        size_t n = print(value, format);
+        return n + println();
+    }
+};
+
+/** Serial port on the process standard output */
+class HardwareSerial : public Print {
+  public:
+    void begin(unsigned long baud) {
+        (void)baud;
+    }
+    operator bool() {
+        return true;
+    }
+    size_t write(uint8_t c);
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+#endif // Arduino_h
@@ -0,0 +1,60 @@
+#include <Wire.h>
+
+TwoWire Wire;
+
+TwoWire::TwoWire() {
+    txAddress_ = 0;
+    txLen_ = 0;
+    transmitting_ = false;
+    rxLen_ = 0;
+    rxPos_ = 0;
+    begins_ = 0;
+    ends_ = 0;
+    hz_ = 100000;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    txAddress_ = address;
+    txLen_ = 0;
+    transmitting_ = true;
+}
+
+uint8_t TwoWire::endTransmission(uint8_t sendStop) {
+    transmitting_ = false;
+    return transmit(txAddress_, txBuffer_, txLen_, sendStop);
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop) {
+    if (quantity > BUFFER_LENGTH) {
+        quantity = BUFFER_LENGTH;
+    }
+    rxLen_ = receive(address, rxBuffer_, quantity, sendStop);
+    rxPos_ = 0;
+    return rxLen_;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (!transmitting_ || txLen_ >= BUFFER_LENGTH) {
+        return 0;
+    }
+    txBuffer_[txLen_++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t quantity) {
+    size_t n = 0;
+    while (n < quantity && write(data[n])) {
+        n++;
+    }
+    return n;
+}
+
+uint8_t TwoWire::transmit(uint8_t /* address */, const uint8_t* /* data */,
+                          uint8_t /* length */, bool /* sendStop */) {
+    return 2;
+}
+
+uint8_t TwoWire::receive(uint8_t /* address */, uint8_t* /* data */,
+                         uint8_t /* length */, bool /* sendStop */) {
+    return 0;
+}
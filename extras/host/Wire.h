@@ -0,0 +1,92 @@
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include <Arduino.h>
+
+/** Bytes buffered by beginTransmission() and requestFrom(), as AVR Wire */
+#define BUFFER_LENGTH 32
+
+/**
+    Host stand-in for the core's TwoWire. Messages are buffered as on the
+    boards, then handed to transmit() and receive(), the place of the
+    core's twi_writeTo()/twi_readFrom(). With nothing on the bus every
+    address is Nak'ed; a test derives from TwoWire to put devices on it.
+*/
+class TwoWire {
+  public:
+    TwoWire();
+    virtual ~TwoWire() {}
+
+    void begin(void) {
+        begins_++;
+    }
+    void end(void) {
+        ends_++;
+    }
+    void setClock(uint32_t hz) {
+        hz_ = hz;
+    }
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) {
+        beginTransmission((uint8_t)address);
+    }
+    uint8_t endTransmission(uint8_t sendStop);
+    uint8_t endTransmission(void) {
+        return endTransmission((uint8_t)true);
+    }
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity) {
+        return requestFrom(address, quantity, (uint8_t)true);
+    }
+    size_t write(uint8_t data);
+    size_t write(const uint8_t* data, size_t quantity);
+    int available(void) {
+        return rxLen_ - rxPos_;
+    }
+    int read(void) {
+        return rxPos_ < rxLen_ ? rxBuffer_[rxPos_++] : -1;
+    }
+
+    /** Number of begin() calls */
+    uint16_t begins(void) {
+        return begins_;
+    }
+    /** Number of end() calls */
+    uint16_t ends(void) {
+        return ends_;
+    }
+    /** Last setClock() value */
+    uint32_t clock(void) {
+        return hz_;
+    }
+
+  protected:
+    /**
+        Send a message: start (or repeated start if the previous message
+        kept the bus), address, bytes, then stop if sendStop
+        \return endTransmission() status: 0 success, 2 address Nak,
+        3 data Nak, 4 other error
+    */
+    virtual uint8_t transmit(uint8_t address, const uint8_t* data, uint8_t length, bool sendStop);
+    /**
+        Read a message, as transmit()
+        \return number of bytes read, 0 on a Nak
+    */
+    virtual uint8_t receive(uint8_t address, uint8_t* data, uint8_t length, bool sendStop);
+
+  private:
+    uint8_t txAddress_;
+    uint8_t txBuffer_[BUFFER_LENGTH];
+    uint8_t txLen_;
+    bool transmitting_;
+    uint8_t rxBuffer_[BUFFER_LENGTH];
+    uint8_t rxLen_;
+    uint8_t rxPos_;
+    uint16_t begins_;
+    uint16_t ends_;
+    uint32_t hz_;
+};
+
+extern TwoWire Wire;
+
+#endif // TwoWire_h
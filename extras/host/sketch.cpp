@@ -0,0 +1,11 @@
+/*
+    Runs an example sketch on the host: setup() once. loop() is left out,
+    as most sketches never return from it. SKETCH is the path of the .ino
+    file, set by the build.
+*/
+#include SKETCH
+
+int main() {
+    setup();
+    return 0;
+}
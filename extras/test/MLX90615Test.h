@@ -0,0 +1,51 @@
+#ifndef __MLX90615_TEST_H__
+#define __MLX90615_TEST_H__
+
+#include <Arduino.h>
+#include <stdio.h>
+
+/*
+    Minimal test harness for the host build: a test is a function of
+    CHECK()s, run by TEST_RUN() from main(). A failed check prints where
+    it failed and the test program exits with status 1.
+*/
+
+static int mlx90615TestFailures = 0;
+
+inline bool mlx90615Check(bool ok, const char* expr, const char* file, int line) {
+    if (!ok) {
+        mlx90615TestFailures++;
+        printf("%s:%d: check failed: %s\n", file, line, expr);
+    }
+    return ok;
+}
+
+inline bool mlx90615CheckEq(long long actual, long long expected, const char* expr,
+                            const char* file, int line) {
+    if (actual != expected) {
+        mlx90615TestFailures++;
+        printf("%s:%d: check failed: %s (%lld, expected %lld)\n", file, line, expr, actual, expected);
+    }
+    return actual == expected;
+}
+
+inline bool mlx90615CheckStr(const char* actual, const char* expected, const char* expr,
+                             const char* file, int line) {
+    bool ok = strcmp(actual, expected) == 0;
+    if (!ok) {
+        mlx90615TestFailures++;
+        printf("%s:%d: check failed: %s (\"%s\", expected \"%s\")\n", file, line, expr, actual, expected);
+    }
+    return ok;
+}
+
+#define CHECK(cond)             mlx90615Check((cond), #cond, __FILE__, __LINE__)
+#define CHECK_EQ(actual, expected) \
+    mlx90615CheckEq((long long)(actual), (long long)(expected), #actual, __FILE__, __LINE__)
+#define CHECK_STR(actual, expected) \
+    mlx90615CheckStr((actual), (expected), #actual, __FILE__, __LINE__)
+
+#define TEST_RUN(test)          do { printf("%s\n", #test); test(); } while (0)
+#define TEST_RESULT()           (mlx90615TestFailures ? 1 : 0)
+
+#endif // __MLX90615_TEST_H__
@@ -0,0 +1,247 @@
+#ifndef __SIM_PINS_H__
+#define __SIM_PINS_H__
+
+#include <Arduino.h>
+#include <MLX90615Sim.h>
+
+#define SIM_PINS_MAX_LANES  8
+
+/**
+    Simulated devices on host pins, for the bit-banged masters: watches
+    the SCL and SDA levels set by pinMode()/digitalWrite(), decodes start,
+    stop, bytes and Acks as a slave would, and pulls SDA low to answer
+    through the MLX90615Sim bus callbacks. One SCL pin is shared by up to
+    SIM_PINS_MAX_LANES SDA lanes, each with its own device (or none).
+
+    Also keeps the SCL timing in micros(): with hostRealTime(false), only
+    the delays of the master count, so the times are exact.
+    Host build only (it hooks extras/host/Arduino.h).
+*/
+class SimPins : public HostPins {
+
+  protected:
+    enum {
+        IDLE,           // Waiting for a start
+        RECEIVE,        // Address or written bytes, Acked by the slave
+        TRANSMIT,       // Read bytes, Acked by the master
+        IGNORE          // Not addressed or Nak: until the next start or stop
+    };
+
+    struct Lane {
+        uint8_t sda;
+        MLX90615Sim* device;
+        uint8_t state;
+        uint8_t bit;        // Data bits clocked in this byte
+        uint8_t data;
+        bool ackSlot;       // Ninth bit of the byte
+        bool ackClocked;    // SCL went high in the Ack slot
+        bool addressed;     // Next RECEIVE byte is the address
+        bool selected;      // Acked its address since the last stop
+        bool masterAck;
+        bool driving;       // Slave pulls SDA low
+        bool level;         // Last SDA level seen
+    };
+
+    uint8_t scl;
+    bool sclLevel;
+    Lane lanes[SIM_PINS_MAX_LANES];
+    uint8_t count;
+
+    static uint32_t shorter(uint32_t a, uint32_t b) {
+        return a < b ? a : b;
+    }
+
+    bool sdaLevel(Lane* lane) {
+        return !(hostDrivesLow(lane->sda) || lane->driving);
+    }
+
+    void onStart(Lane* lane) {
+        lane->state = RECEIVE;
+        lane->addressed = true;
+        lane->bit = 0;
+        lane->data = 0;
+        lane->ackSlot = false;
+        lane->ackClocked = false;
+        lane->driving = false;
+    }
+
+    void onStop(Lane* lane) {
+        if (lane->selected) {
+            lane->device->onStop(micros());
+        }
+        lane->state = IDLE;
+        lane->selected = false;
+        lane->driving = false;
+    }
+
+    void onRise(Lane* lane) {
+        bool level = sdaLevel(lane);
+        if (lane->state != RECEIVE && lane->state != TRANSMIT) {
+            return;
+        }
+        if (lane->ackSlot) {
+            lane->ackClocked = true;
+            lane->masterAck = !level;
+        } else if (lane->bit < 8) {
+            if (lane->state == RECEIVE) {
+                lane->data = lane->data << 1 | level;
+            }
+            lane->bit++;
+        }
+    }
+
+    // Next byte to transmit, its first bit on SDA
+    void load(Lane* lane) {
+        lane->state = TRANSMIT;
+        lane->data = lane->device->onRead();
+        lane->driving = !(lane->data & 0x80);
+    }
+
+    void onFall(Lane* lane) {
+        if (lane->state != RECEIVE && lane->state != TRANSMIT) {
+            return;
+        }
+        if (lane->ackSlot) {
+            if (!lane->ackClocked) {
+                return;
+            }
+            // End of the Ack slot: next byte
+            lane->ackSlot = false;
+            lane->ackClocked = false;
+            lane->bit = 0;
+            lane->driving = false;
+            if (lane->state == TRANSMIT) {
+                if (lane->masterAck) {
+                    load(lane);
+                } else {
+                    lane->state = IGNORE;
+                }
+            } else if (lane->addressed && (lane->data & I2C_READ)) {
+                load(lane);
+            }
+            lane->addressed = false;
+            return;
+        }
+        if (lane->bit < 8) {
+            if (lane->state == TRANSMIT && lane->bit) {
+                lane->driving = !(lane->data & (0x80 >> lane->bit));
+            }
+            return;
+        }
+        // Ack slot after 8 bits
+        lane->ackSlot = true;
+        if (lane->state == TRANSMIT) {
+            lane->driving = false;
+            return;
+        }
+        bool ack = false;
+        if (lane->addressed) {
+            ack = lane->device && lane->device->matches(lane->data >> 1) &&
+                  lane->device->onStart(lane->data, micros());
+            lane->selected |= ack;
+        } else {
+            ack = lane->device->onWrite(lane->data);
+        }
+        lane->driving = ack;
+        if (!ack) {
+            lane->state = IGNORE;
+        }
+    }
+
+  public:
+    uint32_t rises;         // SCL rising edges
+    uint32_t minHigh;       // Shortest SCL high time, us
+    uint32_t minLow;        // Shortest SCL low time between two rising edges, us
+    uint32_t minPeriod;     // Shortest time between two rising edges, us
+    uint32_t lastRise;
+    uint32_t lastFall;
+
+    explicit SimPins(uint8_t sclPin) {
+        scl = sclPin;
+        count = 0;
+        sclLevel = !hostDrivesLow(scl);
+        resetTiming();
+    }
+
+    /** Add a SDA lane, with the device answering on it (0: none). */
+    int addLane(uint8_t sdaPin, MLX90615Sim* device) {
+        if (count >= SIM_PINS_MAX_LANES) {
+            return -1;
+        }
+        Lane* lane = &lanes[count];
+        lane->sda = sdaPin;
+        lane->device = device;
+        lane->state = IDLE;
+        lane->bit = 0;
+        lane->data = 0;
+        lane->addressed = false;
+        lane->selected = false;
+        lane->ackSlot = false;
+        lane->ackClocked = false;
+        lane->masterAck = false;
+        lane->driving = false;
+        lane->level = sdaLevel(lane);
+        return count++;
+    }
+
+    void resetTiming() {
+        rises = 0;
+        minHigh = 0xFFFFFFFF;
+        minLow = 0xFFFFFFFF;
+        minPeriod = 0xFFFFFFFF;
+        lastRise = 0;
+        lastFall = 0;
+    }
+
+    void changed(uint8_t pin) {
+        uint32_t now = micros();
+        bool level = !hostDrivesLow(scl);
+        if (pin == scl && level != sclLevel) {
+            sclLevel = level;
+            if (level) {
+                if (rises) {
+                    minPeriod = shorter(minPeriod, now - lastRise);
+                    minLow = shorter(minLow, now - lastFall);
+                }
+                rises++;
+                lastRise = now;
+            } else {
+                if (rises) {
+                    minHigh = shorter(minHigh, now - lastRise);
+                }
+                lastFall = now;
+            }
+            for (uint8_t i = 0; i < count; i++) {
+                if (level) {
+                    onRise(&lanes[i]);
+                } else {
+                    onFall(&lanes[i]);
+                }
+            }
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            Lane* lane = &lanes[i];
+            bool sda = sdaLevel(lane);
+            if (pin == lane->sda && sda != lane->level && sclLevel) {
+                // SDA moving while SCL is high: start or stop
+                if (sda) {
+                    onStop(lane);
+                } else {
+                    onStart(lane);
+                }
+            }
+            lane->level = sdaLevel(lane);
+        }
+    }
+
+    bool pullsLow(uint8_t pin) {
+        for (uint8_t i = 0; i < count; i++) {
+            if (lanes[i].sda == pin && lanes[i].driving) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+#endif // __SIM_PINS_H__
@@ -0,0 +1,60 @@
+#ifndef __SIM_WIRE_H__
+#define __SIM_WIRE_H__
+
+#include <Wire.h>
+#include <MLX90615Sim.h>
+
+/**
+    TwoWire stand-in on simulated devices: each Wire message becomes a
+    start (or repeated start), the address, the bytes and a stop on a
+    SimI2cMaster, so shape() and the bus counters see the Wire path too.
+    Host build only (it overrides the hooks of extras/host/Wire.h).
+*/
+class SimWire : public TwoWire {
+
+  protected:
+    SimI2cMaster* bus;
+    bool open;              // Previous message kept the bus
+
+    bool address(uint8_t addressRW) {
+        bool ack = open ? bus->restart(addressRW) : bus->start(addressRW);
+        open = true;
+        return ack;
+    }
+
+    void finish(bool sendStop) {
+        if (sendStop) {
+            bus->stop();
+            open = false;
+        }
+    }
+
+    uint8_t transmit(uint8_t addr, const uint8_t* data, uint8_t length, bool sendStop) {
+        uint8_t status = address(addr << 1 | I2C_WRITE) ? 0 : 2;
+        for (uint8_t i = 0; !status && i < length; i++) {
+            if (!bus->write(data[i])) {
+                status = 3;
+            }
+        }
+        finish(status || sendStop);
+        return status;
+    }
+
+    uint8_t receive(uint8_t addr, uint8_t* data, uint8_t length, bool sendStop) {
+        if (!address(addr << 1 | I2C_READ)) {
+            finish(true);
+            return 0;
+        }
+        for (uint8_t i = 0; i < length; i++) {
+            data[i] = bus->read(i == length - 1);
+        }
+        finish(sendStop);
+        return length;
+    }
+
+  public:
+
+    explicit SimWire(SimI2cMaster* i2c) : bus(i2c), open(false) {}
+};
+
+#endif // __SIM_WIRE_H__
@@ -0,0 +1,141 @@
+/*
+    Round-robin scheduler: devices read in turn at the aggregate rate,
+    nothing done before a slot is due, and the achieved rate per device.
+    Circuit breaker: trip, back-off, re-close, and a bus recovery only
+    after bus errors.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615Array.h>
+#include <MLX90615Sim.h>
+
+static SimI2cMaster bus;
+
+static uint32_t simMicros() {
+    return bus.micros();
+}
+
+static void testRoundRobin() {
+    MLX90615Sim devices[3] = {MLX90615Sim(0x5B), MLX90615Sim(0x5C), MLX90615Sim(0x5D)};
+    MLX90615 mlx[3] = {MLX90615(0x5B, &bus), MLX90615(0x5C, &bus), MLX90615(0x5D, &bus)};
+    MLX90615Array<3> array;
+    CHECK_EQ(array.poll(), -1);
+    for (int i = 0; i < 3; i++) {
+        bus.attach(&devices[i]);
+        devices[i].setRaw(MLX90615_OBJECT_TEMPERATURE, 15000 + i);
+        CHECK_EQ(array.add(&mlx[i]), i);
+    }
+    MLX90615 extra(0x5E, &bus);
+    CHECK_EQ(array.add(&extra), -1);
+    CHECK_EQ(array.size(), 3);
+    CHECK_EQ(array.channel(0)->status, -10);
+
+    // 300 reads per second over 3 devices: one slot every 3333 us
+    array.setClock(simMicros);
+    array.setRate(300);
+    int reads = 0;
+    int expected = 0;
+    uint32_t start = bus.micros();
+    while (bus.micros() - start < 1000000UL) {
+        int index = array.poll();
+        if (index >= 0) {
+            CHECK_EQ(index, expected);
+            MLX90615Channel* ch = array.channel(index);
+            CHECK_EQ(ch->status, 0);
+            CHECK_EQ(ch->data.object, 15000 + index);
+            expected = (expected + 1) % 3;
+            reads++;
+            // Not due again before the next slot
+            CHECK_EQ(array.poll(), -1);
+        }
+        bus.advance(100);
+    }
+    CHECK(reads >= 299 && reads <= 301);
+    for (int i = 0; i < 3; i++) {
+        CHECK(array.rate(i) > 99 && array.rate(i) < 101);
+        CHECK(array.jitter(i) < 200);
+    }
+
+    // Rate 0: back to back, a read at every poll()
+    array.setRate(0);
+    for (int i = 0; i < 6; i++) {
+        CHECK_EQ(array.poll(), (expected + i) % 3);
+    }
+    for (int i = 0; i < 3; i++) {
+        bus.detach(&devices[i]);
+    }
+}
+
+static void testBreaker() {
+    MLX90615Sim good(0x5B);
+    MLX90615Sim bad(0x5C);
+    MLX90615 mlx[2] = {MLX90615(0x5B, &bus), MLX90615(0x5C, &bus)};
+    MLX90615Array<2> array;
+    bus.attach(&good);
+    for (int i = 0; i < 2; i++) {
+        mlx[i].setRetries(0);
+        array.add(&mlx[i]);
+    }
+    array.setClock(simMicros);
+
+    // A bad PEC came over a working bus: counted, but no recovery
+    bus.attach(&bad);
+    bad.injectBadPec(1);
+    CHECK_EQ(array.poll(), 0);
+    CHECK_EQ(array.poll(), 1);
+    CHECK_EQ(array.channel(1)->status, -1);
+    CHECK_EQ(array.channel(1)->failures, 1);
+    CHECK(bus.shape()[0] == 'S');
+
+    // SDA held low: the START times out, and the bus is clocked free
+    bad.injectStuckSda(4);
+    CHECK_EQ(array.poll(), 0);
+    CHECK_EQ(array.channel(0)->status, -2);
+    CHECK_STR(bus.shape(), "CCCCP");
+    CHECK_EQ(array.poll(), 1);
+    CHECK_EQ(array.channel(1)->status, 0);
+    CHECK_EQ(array.channel(1)->failures, 0);
+
+    // Gone: a Nak per read, recovered each time, tripped at the threshold
+    bus.detach(&bad);
+    for (int i = 0; i < MLX90615_BREAKER_THRESHOLD; i++) {
+        CHECK(!array.tripped(1));
+        CHECK_EQ(array.poll(), 0);
+        CHECK_EQ(array.poll(), 1);
+        CHECK_EQ(array.channel(1)->status, -2);
+        CHECK_STR(bus.shape(), "P");
+    }
+    CHECK(array.tripped(1));
+    CHECK_EQ(array.channel(1)->trips, 1);
+
+    // Open: its slots go to the healthy device until the back-off is over
+    uint32_t open = bus.micros();
+    while (bus.micros() - open < MLX90615_BACKOFF_MIN_MS * 1000UL - 500) {
+        CHECK_EQ(array.poll(), 0);
+        bus.advance(100);
+    }
+    bus.advance(500);
+    // Half-open: one trial read, failed, back-off doubled
+    CHECK_EQ(array.poll(), 1);
+    CHECK(array.tripped(1));
+    CHECK_EQ(array.channel(1)->trips, 1);
+    bus.advance(MLX90615_BACKOFF_MIN_MS * 1000UL);
+    CHECK_EQ(array.poll(), 0);
+    CHECK_EQ(array.poll(), 0);
+    bus.advance(MLX90615_BACKOFF_MIN_MS * 1000UL);
+
+    // Back: the trial succeeds and closes the breaker
+    bus.attach(&bad);
+    CHECK_EQ(array.poll(), 1);
+    CHECK_EQ(array.channel(1)->status, 0);
+    CHECK(!array.tripped(1));
+    CHECK_EQ(array.poll(), 0);
+    CHECK_EQ(array.poll(), 1);
+    bus.detach(&bad);
+    bus.detach(&good);
+}
+
+int main() {
+    TEST_RUN(testRoundRobin);
+    TEST_RUN(testBreaker);
+    return TEST_RESULT();
+}
@@ -0,0 +1,209 @@
+/*
+    Driver bus sessions against simulated devices: values, transaction
+    shapes (see SimI2cMaster::shape()), PEC retries and error counters.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615.h>
+#include <MLX90615Sim.h>
+
+static void testReadReg() {
+    SimI2cMaster bus;
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &bus);
+    MLX90615T<MLX90615SimTransport> mlxT(MLX90615_DefaultAddr, &bus);
+    bus.attach(&device);
+    device.setTemperature(MLX90615_OBJECT_TEMPERATURE, 36.6);
+
+    uint16_t value = 0;
+    CHECK_EQ(mlx.readReg(MLX90615_OBJECT_TEMPERATURE, &value), 0);
+    CHECK_EQ(MLX90615::rawToInt<MLX90615_CENTI_CELSIUS>(value), 3660);
+    CHECK_STR(bus.shape(), "SAWRArrnP");
+    value = 0;
+    CHECK_EQ(mlxT.readReg(MLX90615_OBJECT_TEMPERATURE, &value), 0);
+    CHECK_EQ(MLX90615::rawToInt<MLX90615_CENTI_CELSIUS>(value), 3660);
+    CHECK_STR(bus.shape(), "SAWRArrnP");
+    CHECK(fabs(mlx.getTemperature(MLX90615_OBJECT_TEMPERATURE) - 36.6) < 0.01);
+
+    I2cBusStats before = bus.stats();
+    mlx.readReg(MLX90615_OBJECT_TEMPERATURE, &value);
+    I2cBusStats d = bus.stats() - before;
+    CHECK_EQ(d.transactions, 1);
+    CHECK_EQ(d.restarts, 1);
+    CHECK_EQ(d.bytes, 6);
+    CHECK_EQ(d.sclCycles, 57);
+}
+
+static void testReadAll() {
+    SimI2cMaster bus;
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &bus);
+    bus.attach(&device);
+    device.setRaw(MLX90615_RAW_IR_DATA, 0x0123);
+    device.setRaw(MLX90615_AMBIENT_TEMPERATURE, 14908);
+    device.setRaw(MLX90615_OBJECT_TEMPERATURE, 15488);
+
+    MLX90615Data data;
+    I2cBusStats before = bus.stats();
+    CHECK_EQ(mlx.readAll(&data), 0);
+    CHECK_STR(bus.shape(), "SAWRArrnRAWRArrnRAWRArrnP");
+    CHECK_EQ((bus.stats() - before).transactions, 1);
+    CHECK_EQ(data.rawIr, 0x0123);
+    CHECK_EQ(data.ambient, 14908);
+    CHECK_EQ(data.object, 15488);
+}
+
+static void testWriteReg() {
+    SimI2cMaster bus;
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &bus);
+    bus.attach(&device);
+
+    CHECK_EQ(mlx.writeReg(MLX90615_EEPROM_EMISSIVITY, 0x0000), 0);
+    CHECK_STR(bus.shape(), "SAWWWWP");
+    CHECK_EQ(device.getEEPROM(MLX90615_EEPROM_EMISSIVITY), 0x0000);
+    // Busy writing the cell: not acknowledged
+    CHECK_EQ(mlx.writeReg(MLX90615_EEPROM_EMISSIVITY, 0x3d70), -2);
+    bus.advance(MLX90615_SIM_EEPROM_WRITE_US);
+    CHECK_EQ(mlx.writeReg(MLX90615_EEPROM_EMISSIVITY, 0x3d70), 0);
+    bus.advance(MLX90615_SIM_EEPROM_WRITE_US);
+
+    uint16_t value = 0;
+    CHECK_EQ(mlx.readReg(MLX90615_EEPROM_EMISSIVITY, &value), 0);
+    CHECK_EQ(value, 0x3d70);
+}
+
+static void testProbe() {
+    SimI2cMaster bus;
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &bus);
+    MLX90615 nobody(0x5A, &bus);
+    bus.attach(&device);
+
+    CHECK_EQ(mlx.probe(), 0);
+    CHECK_STR(bus.shape(), "SAP");
+    CHECK_EQ(nobody.probe(), -2);
+    nobody.setRetries(0);
+    uint16_t value;
+    CHECK_EQ(nobody.readReg(MLX90615_OBJECT_TEMPERATURE, &value), -2);
+    CHECK_STR(bus.shape(), "SNP");
+}
+
+static void testRetries() {
+    SimI2cMaster bus;
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &bus);
+    bus.attach(&device);
+    device.setTemperature(MLX90615_OBJECT_TEMPERATURE, 36.6);
+
+    uint16_t value = 0;
+    device.injectBadPec(1);
+    device.injectNak(1);
+    CHECK_EQ(mlx.readReg(MLX90615_OBJECT_TEMPERATURE, &value), 0);
+    CHECK_EQ(value, 15488);
+    MLX90615Stats stats = mlx.getStats();
+    CHECK_EQ(stats.reads, 1);
+    CHECK_EQ(stats.crcErrors, 1);
+    CHECK_EQ(stats.naks, 1);
+    CHECK_EQ(stats.retries, 2);
+
+    // One more error than retries
+    mlx.resetStats();
+    device.injectBadPec(MLX90615_DEFAULT_RETRIES + 1);
+    CHECK_EQ(mlx.readReg(MLX90615_OBJECT_TEMPERATURE, &value), -1);
+    CHECK_EQ(mlx.getStats().crcErrors, MLX90615_DEFAULT_RETRIES + 1);
+    CHECK_EQ(mlx.getStats().retries, MLX90615_DEFAULT_RETRIES);
+
+    // A bad PEC in the middle of readAll closes the session
+    mlx.setRetries(0);
+    device.injectBadPec(1);
+    MLX90615Data data;
+    CHECK_EQ(mlx.readAll(&data), -1);
+    CHECK_STR(bus.shape(), "SAWRArrnP");
+}
+
+static void testSubmit() {
+    SimI2cMaster bus;
+    MLX90615Sim devices[2] = {MLX90615Sim(0x5C), MLX90615Sim(0x5D)};
+    MLX90615 mlx(0x5C, &bus);
+    const uint8_t addresses[2] = {0x5C, 0x5D};
+    for (int i = 0; i < 2; i++) {
+        bus.attach(&devices[i]);
+        devices[i].setRaw(MLX90615_OBJECT_TEMPERATURE, 15000 + i);
+        devices[i].setRaw(MLX90615_AMBIENT_TEMPERATURE, 14000 + i);
+    }
+
+    MLX90615Transaction list[5];
+    mlx90615Read(&list[0], addresses[0], MLX90615_OBJECT_TEMPERATURE);
+    mlx90615Read(&list[1], addresses[0], MLX90615_AMBIENT_TEMPERATURE);
+    mlx90615Read(&list[2], addresses[1], MLX90615_OBJECT_TEMPERATURE);
+    mlx90615Read(&list[3], addresses[1], MLX90615_AMBIENT_TEMPERATURE);
+    mlx90615Write(&list[4], addresses[1], MLX90615_EEPROM_EMISSIVITY, 0x0000);
+    I2cBusStats before = bus.stats();
+    CHECK_EQ(mlx.submit(list, 5), 0);
+    // The four reads in one session, the write in another
+    CHECK_EQ((bus.stats() - before).transactions, 2);
+    for (int i = 0; i < 2; i++) {
+        CHECK_EQ(list[i * 2].status, 0);
+        CHECK_EQ(mlx90615Value(&list[i * 2]), 15000 + i);
+        CHECK_EQ(mlx90615Value(&list[i * 2 + 1]), 14000 + i);
+    }
+    CHECK_EQ(list[4].status, 0);
+    CHECK_EQ(devices[1].getEEPROM(MLX90615_EEPROM_EMISSIVITY), 0x0000);
+}
+
+static void testAsync() {
+    SimI2cMaster bus;
+    MLX90615Sim devices[2] = {MLX90615Sim(0x5C), MLX90615Sim(0x5D)};
+    MLX90615 mlx[2] = {MLX90615(0x5C, &bus), MLX90615(0x5D, &bus)};
+    I2cAsync engine(&bus);
+    MLX90615AsyncRead requests[2] = {};
+    for (int i = 0; i < 2; i++) {
+        bus.attach(&devices[i]);
+        devices[i].setRaw(MLX90615_OBJECT_TEMPERATURE, 15000 + i);
+        CHECK_EQ(mlx[i].readRegAsync(&engine, MLX90615_OBJECT_TEMPERATURE, &requests[i]), 0);
+    }
+    uint16_t value = 0;
+    CHECK_EQ(MLX90615::readRegResult(&requests[0], &value), I2C_PENDING);
+    CHECK_EQ(mlx[0].readRegAsync(&engine, MLX90615_OBJECT_TEMPERATURE, &requests[0]), 1);
+    while (engine.poll());
+    for (int i = 0; i < 2; i++) {
+        CHECK_EQ(MLX90615::readRegResult(&requests[i], &value), 0);
+        CHECK_EQ(value, 15000 + i);
+    }
+    CHECK_STR(bus.shape(), "SAWRArrnP");
+
+    // Rejected on Wire
+    MLX90615 wired(0x5C, &Wire);
+    CHECK_EQ(wired.readRegAsync(&engine, MLX90615_OBJECT_TEMPERATURE, &requests[0]), -10);
+}
+
+static void testRecover() {
+    SimI2cMaster bus;
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &bus);
+    bus.attach(&device);
+    mlx.setRetries(0);
+
+    uint16_t value;
+    device.injectStuckSda(5);
+    CHECK_EQ(mlx.readReg(MLX90615_OBJECT_TEMPERATURE, &value), -2);
+    CHECK_STR(bus.shape(), "STP");
+    CHECK_EQ(mlx.recover(), 0);
+    CHECK_STR(bus.shape(), "CCCCCP");
+    CHECK_EQ(mlx.readReg(MLX90615_OBJECT_TEMPERATURE, &value), 0);
+
+    device.injectStuckSda(0xFFFF);
+    CHECK_EQ(mlx.recover(), -2);
+}
+
+int main() {
+    TEST_RUN(testReadReg);
+    TEST_RUN(testReadAll);
+    TEST_RUN(testWriteReg);
+    TEST_RUN(testProbe);
+    TEST_RUN(testRetries);
+    TEST_RUN(testSubmit);
+    TEST_RUN(testAsync);
+    TEST_RUN(testRecover);
+    return TEST_RESULT();
+}
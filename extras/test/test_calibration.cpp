@@ -0,0 +1,71 @@
+/*
+    Fixed point compensation against a double precision reference, for
+    the accuracy documented in MLX90615Calibration.h.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615Calibration.h>
+#include <math.h>
+
+// Emissivity, gain, offset (°C), reflected (°C)
+static const float materials[][4] = {
+    {0.95, 1.0, 0.0, MLX90615_REFLECTED_AMBIENT},
+    {0.60, 1.0, 0.0, 40.0},
+    {0.30, 1.02, -0.5, MLX90615_REFLECTED_AMBIENT},
+    {0.10, 1.0, 0.0, 100.0},
+};
+static const MLX90615Profile profiles[] = {
+    mlx90615Profile(0.95),
+    mlx90615Profile(0.60, 1.0, 0.0, 40.0),
+    mlx90615Profile(0.30, 1.02, -0.5),
+    mlx90615Profile(0.10, 1.0, 0.0, 100.0),
+};
+static const double bounds[] = {0.50, 0.53, 0.51, 0.50};
+
+static double reference(const float* m, uint16_t object, uint16_t ambient) {
+    double to = object * 0.02, ta = ambient * 0.02;
+    double tr = m[3] < -273.0 ? ta : m[3] + 273.16;
+    double t4 = pow(tr, 4) + (pow(to, 4) - pow(ta, 4)) / m[0] + (pow(ta, 4) - pow(tr, 4)) / m[0];
+    if (t4 <= 0) {
+        return 0;
+    }
+    double raw = ((sqrt(sqrt(t4)) - 273.16) * m[1] + 273.16 + m[2]) * 50;
+    return raw < 0 ? 0 : raw > 0x7FFF ? 0x7FFF : raw;
+}
+
+static void testAccuracy() {
+    const uint16_t ambients[] = {11658, 13658, 14908, 16658, 17908};    // -40 .. 85 °C
+    for (uint8_t p = 0; p < sizeof(profiles) / sizeof(profiles[0]); p++) {
+        double worst = 0;
+        for (uint8_t a = 0; a < sizeof(ambients) / sizeof(ambients[0]); a++) {
+            for (uint16_t object = 11658; object <= 21658; object++) {    // -40 .. 160 °C
+                double error = fabs(MLX90615Compensator::compensate(&profiles[p], object, ambients[a]) -
+                                    reference(materials[p], object, ambients[a]));
+                worst = error > worst ? error : worst;
+            }
+        }
+        // Small margin: the reference takes the float parameters as they are
+        if (worst > bounds[p] + 0.005) {
+            printf("e=%.2f: %.3f LSB\n", materials[p][0], worst);
+        }
+        CHECK(worst <= bounds[p] + 0.005);
+    }
+}
+
+static void testLimits() {
+    // Error flag ignored, results clamped to the register range
+    CHECK_EQ(MLX90615Compensator::compensate(&profiles[0], 0x3AF7 | 0x8000, 14908),
+             MLX90615Compensator::compensate(&profiles[0], 0x3AF7, 14908));
+    CHECK_EQ(MLX90615Compensator::compensate(&profiles[3], 0x7FFF, 0), 0x7FFF);
+    CHECK_EQ(MLX90615Compensator::compensate(&profiles[3], 0, 0x7FFF), 0);
+    // e = 1, no correction: the reading itself
+    const MLX90615Profile identity = mlx90615Profile(1.0);
+    for (uint16_t object = 11658; object <= 21658; object += 100) {
+        CHECK_EQ(MLX90615Compensator::compensate(&identity, object, 14908), object);
+    }
+}
+
+int main() {
+    TEST_RUN(testAccuracy);
+    TEST_RUN(testLimits);
+    return TEST_RESULT();
+}
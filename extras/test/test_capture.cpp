@@ -0,0 +1,107 @@
+/*
+    Raw IR capture: decimation, session lengths, dropped reads, a device
+    gone, and the rate measured on the simulated bus clock.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615Capture.h>
+#include <MLX90615Sim.h>
+
+static SimI2cMaster bus;
+
+static uint32_t simMicros() {
+    return bus.micros();
+}
+
+static void testRawIrToInt() {
+    CHECK_EQ(MLX90615IrCapture::rawIrToInt(0x0005), 5);
+    CHECK_EQ(MLX90615IrCapture::rawIrToInt(0x8005), -5);
+    CHECK_EQ(MLX90615IrCapture::rawIrToInt(0x7FFF), 32767);
+    CHECK_EQ(MLX90615IrCapture::rawIrToInt(0xFFFF), -32767);
+    CHECK_EQ(MLX90615IrCapture::rawIrToInt(0x8000), 0);
+}
+
+static void testDecimation() {
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &bus);
+    bus.attach(&device);
+    device.setRaw(MLX90615_RAW_IR_DATA, 0x8000 | 100);
+    MLX90615IrCapture capture(&mlx, 4, 8);
+    capture.setClock(simMicros);
+
+    // 10 samples of 4 reads: 40 reads in 5 sessions of 8
+    int16_t buffer[10];
+    bus.resetStats();
+    uint32_t t0 = bus.micros();
+    CHECK_EQ(capture.capture(buffer, 10), 10);
+    uint32_t elapsed = bus.micros() - t0;
+    for (uint8_t i = 0; i < 10; i++) {
+        CHECK_EQ(buffer[i], -100);
+    }
+    CHECK_EQ(capture.getSamples(), 10);
+    CHECK_EQ(capture.getReads(), 40);
+    CHECK_EQ(capture.getDropped(), 0);
+    CHECK_EQ(bus.stats().transactions, 5);
+    CHECK_EQ(bus.stats().restarts, 40 + 35);
+
+    // Rate: the samples over the bus time spent
+    CHECK(elapsed > 0);
+    float expected = 10 * 1000000.0 / elapsed;
+    CHECK(capture.sps() > expected * 0.999 && capture.sps() < expected * 1.001);
+
+    // No longer session than the reads still needed: 3 reads, not 8
+    capture.reset();
+    CHECK_EQ(capture.sps(), 0);
+    capture.setDecimation(1);
+    bus.resetStats();
+    CHECK_EQ(capture.capture(buffer, 3), 3);
+    CHECK_EQ(capture.getReads(), 3);
+    CHECK_EQ(bus.stats().transactions, 1);
+
+    // Limits of the settings
+    capture.setDecimation(0);
+    capture.setBurst(0);
+    capture.reset();
+    bus.resetStats();
+    CHECK_EQ(capture.capture(buffer, 2), 2);
+    CHECK_EQ(capture.getReads(), 2);
+    CHECK_EQ(bus.stats().transactions, 2);
+    capture.setBurst(200);
+    capture.reset();
+    bus.resetStats();
+    CHECK_EQ(capture.capture(buffer, 10), 10);
+    CHECK_EQ(bus.stats().transactions, 1);
+    bus.detach(&device);
+}
+
+static void testFailures() {
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &bus);
+    mlx.setRetries(0);
+    bus.attach(&device);
+    device.setRaw(MLX90615_RAW_IR_DATA, 250);
+    MLX90615IrCapture capture(&mlx, 2, 4);
+
+    // A bad PEC drops one read: its sample averages the other one
+    int16_t buffer[4];
+    device.injectBadPec(1);
+    CHECK_EQ(capture.capture(buffer, 4), 4);
+    for (uint8_t i = 0; i < 4; i++) {
+        CHECK_EQ(buffer[i], 250);
+    }
+    CHECK_EQ(capture.getDropped(), 1);
+    CHECK_EQ(capture.getReads(), 8);
+
+    // Device gone: nothing stored, every attempt counted as dropped
+    bus.detach(&device);
+    capture.reset();
+    CHECK_EQ(capture.capture(buffer, 4), 0);
+    CHECK_EQ(capture.getDropped(), 2);
+    CHECK_EQ(capture.getSamples(), 0);
+}
+
+int main() {
+    TEST_RUN(testRawIrToInt);
+    TEST_RUN(testDecimation);
+    TEST_RUN(testFailures);
+    return TEST_RESULT();
+}
@@ -0,0 +1,69 @@
+/*
+    Integer temperature conversions: rawToInt() and intToRaw() over the
+    whole 16-bit register range.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615.h>
+
+template <uint8_t unit>
+static void checkRoundTrip() {
+    for (uint32_t raw = 0; raw <= 0xFFFF; raw++) {
+        // Bit 15 is out of the temperature range: clamped
+        uint16_t expected = raw > 0x7FFF ? 0x7FFF : raw;
+        CHECK_EQ(MLX90615::intToRaw<unit>(MLX90615::rawToInt<unit>(raw)), expected);
+    }
+}
+
+template <uint8_t unit>
+static void checkNearest() {
+    // Values between two raw steps go to the nearest one
+    for (uint16_t raw = 0; raw < 0x7FFF; raw++) {
+        int32_t low = MLX90615::rawToInt<unit>(raw);
+        int32_t high = MLX90615::rawToInt<unit>(raw + 1);
+        CHECK(high > low);
+        for (int32_t value = low; value <= high; value++) {
+            uint16_t back = MLX90615::intToRaw<unit>(value);
+            if (2 * value < low + high) {
+                CHECK_EQ(back, raw);
+            } else if (2 * value > low + high) {
+                CHECK_EQ(back, raw + 1);
+            } else {
+                CHECK(back == raw || back == raw + 1);
+            }
+        }
+    }
+}
+
+static void testCelsius() {
+    CHECK_EQ(MLX90615::rawToInt<MLX90615_CENTI_CELSIUS>(0x3AF7), 2874);
+    checkRoundTrip<MLX90615_CENTI_CELSIUS>();
+    checkNearest<MLX90615_CENTI_CELSIUS>();
+}
+
+static void testFahrenheit() {
+    // 0x3AF7: 28.74 °C, 83.73 °F
+    CHECK_EQ(MLX90615::rawToInt<MLX90615_CENTI_FAHRENHEIT>(0x3AF7), 8373);
+    CHECK_EQ(MLX90615::rawToInt<MLX90615_CENTI_FAHRENHEIT>(0), -45969);
+    checkRoundTrip<MLX90615_CENTI_FAHRENHEIT>();
+    checkNearest<MLX90615_CENTI_FAHRENHEIT>();
+}
+
+static void testKelvin() {
+    checkRoundTrip<MLX90615_KELVIN_X50>();
+    CHECK_EQ(MLX90615::intToRaw<MLX90615_KELVIN_X50>(-1), 0);
+}
+
+static void testClamp() {
+    CHECK_EQ(MLX90615::intToRaw<MLX90615_CENTI_CELSIUS>(-30000), 0);
+    CHECK_EQ(MLX90615::intToRaw<MLX90615_CENTI_FAHRENHEIT>(-50000), 0);
+    CHECK_EQ(MLX90615::intToRaw<MLX90615_CENTI_CELSIUS>(100000), 0x7FFF);
+    CHECK_EQ(MLX90615::intToRaw<MLX90615_CENTI_FAHRENHEIT>(200000), 0x7FFF);
+}
+
+int main() {
+    TEST_RUN(testCelsius);
+    TEST_RUN(testFahrenheit);
+    TEST_RUN(testKelvin);
+    TEST_RUN(testClamp);
+    return TEST_RESULT();
+}
@@ -0,0 +1,54 @@
+/*
+    CRC-8 (SMBus PEC): the nibble, table and compile-time implementations
+    against the bitwise reference, for every byte and starting value, and
+    against a PEC frame from the datasheet.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615.h>
+
+static void testAllBytes() {
+    int mismatches = 0;
+    for (int crc = 0; crc < 256; crc++) {
+        for (int value = 0; value < 256; value++) {
+            uint8_t data = (uint8_t)value;
+            uint8_t reference = mlx90615Crc8Bitwise((uint8_t)crc, &data, 1);
+            mismatches += mlx90615Crc8Nibble((uint8_t)crc, &data, 1) != reference;
+            mismatches += mlx90615Crc8Table((uint8_t)crc, &data, 1) != reference;
+            mismatches += mlx90615Crc8((uint8_t)crc, data) != reference;
+            mismatches += mlx90615Crc8((uint8_t)crc, &data, 1) != reference;
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+
+    // Over a buffer: the running CRC is carried from byte to byte
+    uint8_t buffer[256];
+    for (int i = 0; i < 256; i++) {
+        buffer[i] = (uint8_t)(i * 7 + 3);
+    }
+    uint8_t reference = mlx90615Crc8Bitwise(0, buffer, 256);
+    CHECK_EQ(mlx90615Crc8Nibble(0, buffer, 256), reference);
+    CHECK_EQ(mlx90615Crc8Table(0, buffer, 256), reference);
+    CHECK_EQ(mlx90615Crc8(0, buffer, 256), reference);
+}
+
+static void testPecFrame() {
+    // Read of RAM 0x07 at address 0x5A: B4 07 B5 D2 3A, PEC 30
+    uint8_t frame[5] = {0xB4, 0x07, 0xB5, 0xD2, 0x3A};
+    CHECK_EQ(mlx90615Crc8Bitwise(0, frame, 5), 0x30);
+    CHECK_EQ(mlx90615Crc8Nibble(0, frame, 5), 0x30);
+    CHECK_EQ(mlx90615Crc8Table(0, frame, 5), 0x30);
+    CHECK_EQ(mlx90615Crc8(0, frame, 5), 0x30);
+    CHECK_EQ(MLX90615::crc8Msb(MLX90615_PEC_POLY, frame, 5), 0x30);
+
+    // Compile-time PECs of write and command frames
+    uint8_t write[4] = {0xB6, MLX90615_EEPROM_EMISSIVITY, 0x70, 0x3D};
+    CHECK_EQ(mlx90615WritePec(0x5B, MLX90615_EEPROM_EMISSIVITY, 0x3D70), mlx90615Crc8Bitwise(0, write, 4));
+    uint8_t command[2] = {0xB6, 0xC6};
+    CHECK_EQ(mlx90615CommandPec(0x5B, 0xC6), mlx90615Crc8Bitwise(0, command, 2));
+}
+
+int main() {
+    TEST_RUN(testAllBytes);
+    TEST_RUN(testPecFrame);
+    return TEST_RESULT();
+}
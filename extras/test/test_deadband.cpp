@@ -0,0 +1,125 @@
+/*
+    Change detection: deadband against the last reported sample (drifts
+    add up, noise does not toggle), separate bands, heartbeat, and poll()
+    on a simulated device.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615Deadband.h>
+#include <MLX90615Sim.h>
+
+static MLX90615Data sample(uint16_t object, uint16_t ambient) {
+    MLX90615Data data;
+    data.rawIr = 0;
+    data.ambient = ambient;
+    data.object = object;
+    return data;
+}
+
+static void testDeadband() {
+    MLX90615Deadband deadband(0, 5, 0);
+    MLX90615Data data = sample(15000, 14000);
+    CHECK_EQ(deadband.update(&data, 0), MLX90615_EVENT_OBJECT | MLX90615_EVENT_AMBIENT);
+
+    // Inside the band, either way
+    data = sample(15004, 14000);
+    CHECK_EQ(deadband.update(&data, 10), 0);
+    data = sample(14996, 13996);
+    CHECK_EQ(deadband.update(&data, 20), 0);
+    CHECK_EQ(deadband.reported().object, 15000);
+
+    // At the band
+    data = sample(15005, 14000);
+    CHECK_EQ(deadband.update(&data, 30), MLX90615_EVENT_OBJECT);
+    CHECK_EQ(deadband.reported().object, 15005);
+    data = sample(15005, 13995);
+    CHECK_EQ(deadband.update(&data, 40), MLX90615_EVENT_AMBIENT);
+
+    // A slow drift of 1 LSB per sample is reported every 5
+    uint8_t reports = 0;
+    for (uint16_t i = 1; i <= 20; i++) {
+        data = sample(15005 + i, 13995);
+        if (deadband.update(&data, 50 + i)) {
+            reports++;
+            CHECK_EQ(i % 5, 0);
+        }
+    }
+    CHECK_EQ(reports, 4);
+
+    // Noise around a report does not toggle
+    for (uint16_t i = 0; i < 20; i++) {
+        data = sample(i & 1 ? 15029 : 15021, 13995);
+        CHECK_EQ(deadband.update(&data, 100 + i), 0);
+    }
+
+    // Separate bands
+    deadband.setDeadband(50, 1);
+    data = sample(15060, 13996);
+    CHECK_EQ(deadband.update(&data, 200), MLX90615_EVENT_AMBIENT);
+    data = sample(15109, 13996);
+    CHECK_EQ(deadband.update(&data, 210), 0);
+    data = sample(15110, 13996);
+    CHECK_EQ(deadband.update(&data, 220), MLX90615_EVENT_OBJECT);
+
+    // reset(): the next sample is reported whatever its value
+    deadband.reset();
+    CHECK_EQ(deadband.update(&data, 230), MLX90615_EVENT_OBJECT | MLX90615_EVENT_AMBIENT);
+}
+
+static void testHeartbeat() {
+    MLX90615Deadband deadband(0, 5, 1000);
+    MLX90615Data data = sample(15000, 14000);
+    CHECK_EQ(deadband.update(&data, 5000), MLX90615_EVENT_OBJECT | MLX90615_EVENT_AMBIENT);
+    CHECK_EQ(deadband.update(&data, 5999), 0);
+    CHECK_EQ(deadband.update(&data, 6000), MLX90615_EVENT_HEARTBEAT);
+    CHECK_EQ(deadband.update(&data, 6999), 0);
+
+    // A change restarts the silence
+    data = sample(15010, 14000);
+    CHECK_EQ(deadband.update(&data, 6500), MLX90615_EVENT_OBJECT);
+    CHECK_EQ(deadband.update(&data, 7499), 0);
+    CHECK_EQ(deadband.update(&data, 7500), MLX90615_EVENT_HEARTBEAT);
+
+    // Across the millis() wrap-around
+    deadband.reset();
+    CHECK(deadband.update(&data, 0xFFFFFF00UL));
+    CHECK_EQ(deadband.update(&data, 0x00000200UL), 0);
+    CHECK_EQ(deadband.update(&data, 0x000002E8UL), MLX90615_EVENT_HEARTBEAT);
+
+    // Disabled
+    deadband.setHeartbeat(0);
+    CHECK_EQ(deadband.update(&data, 0x10000000UL), 0);
+}
+
+static void testPoll() {
+    SimI2cMaster bus;
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &bus);
+    bus.attach(&device);
+    mlx.setRetries(0);
+    MLX90615Deadband deadband(&mlx, 5, 60000);
+    device.setRaw(MLX90615_OBJECT_TEMPERATURE, 15000);
+
+    MLX90615Data data;
+    CHECK_EQ(deadband.poll(&data), MLX90615_EVENT_OBJECT | MLX90615_EVENT_AMBIENT);
+    CHECK_EQ(data.object, 15000);
+    CHECK_EQ(deadband.poll(&data), 0);
+    device.setRaw(MLX90615_OBJECT_TEMPERATURE, 15006);
+    CHECK_EQ(deadband.poll(&data), MLX90615_EVENT_OBJECT);
+    delay(60000);
+    CHECK_EQ(deadband.poll(&data), MLX90615_EVENT_HEARTBEAT);
+
+    // Errors are passed through, without a report
+    device.injectBadPec(1);
+    CHECK_EQ(deadband.poll(&data), -1);
+    device.injectNak(1);
+    CHECK_EQ(deadband.poll(&data), -2);
+    MLX90615Deadband none(0);
+    CHECK_EQ(none.poll(&data), -10);
+}
+
+int main() {
+    TEST_RUN(testDeadband);
+    TEST_RUN(testHeartbeat);
+    TEST_RUN(testPoll);
+    return TEST_RESULT();
+}
@@ -0,0 +1,111 @@
+/*
+    EEPROM manager: shadow, skipped writes, verified writes, and a write
+    that fails after the erase.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615Eeprom.h>
+#include <MLX90615Sim.h>
+
+static SimI2cMaster bus;
+
+// Every poll() lets some simulated time pass
+static uint32_t simMicros() {
+    bus.advance(100);
+    return bus.micros();
+}
+
+static void testSetAndVerify() {
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &bus);
+    MLX90615Eeprom eeprom(&mlx);
+    bus.attach(&device);
+    eeprom.setClock(simMicros);
+
+    uint16_t value = 0;
+    CHECK_EQ(eeprom.get(MLX90615_EEPROM_EMISSIVITY, &value), -3);
+    CHECK_EQ(eeprom.load(), 0);
+    CHECK_EQ(eeprom.get(MLX90615_EEPROM_EMISSIVITY, &value), 0);
+    CHECK_EQ(value, Default_Emissivity);
+    CHECK_EQ(eeprom.set(0x14, 0x1234), -3);
+
+    CHECK_EQ(eeprom.set(MLX90615_EEPROM_EMISSIVITY, Default_Emissivity), 0);
+    CHECK_EQ(eeprom.getSkipped(), 1);
+    CHECK_EQ(eeprom.set(MLX90615_EEPROM_EMISSIVITY, 0x3d70), 1);
+    CHECK_EQ(eeprom.setBits(MLX90615_EEPROM_CONFIG, 0x7000, 0x4000), 1);
+    CHECK(eeprom.busy());
+    CHECK_EQ(eeprom.commit(), 0);
+    CHECK(!eeprom.busy());
+    CHECK_EQ(eeprom.getWrites(), 2);
+    CHECK_EQ(device.getEEPROM(MLX90615_EEPROM_EMISSIVITY), 0x3d70);
+    CHECK_EQ(device.getEEPROM(MLX90615_EEPROM_CONFIG), 0x44e9);
+    CHECK_EQ(eeprom.get(MLX90615_EEPROM_EMISSIVITY, &value), 0);
+    CHECK_EQ(value, 0x3d70);
+    bus.detach(&device);
+}
+
+static void testWriteFailsAfterErase() {
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &bus);
+    MLX90615Eeprom eeprom(&mlx);
+    bus.attach(&device);
+    eeprom.setClock(simMicros);
+    CHECK_EQ(eeprom.load(), 0);
+
+    CHECK_EQ(eeprom.set(MLX90615_EEPROM_EMISSIVITY, 0x3d70), 1);
+    int status;
+    while ((status = eeprom.poll()) == 1 && eeprom.phase() != MLX90615_EEPROM_WRITE);
+    CHECK_EQ(status, 1);
+    CHECK_EQ(device.getEEPROM(MLX90615_EEPROM_EMISSIVITY), 0x0000);
+
+    // The write is not acknowledged: erased, not written, still queued
+    device.injectNak(1);
+    CHECK_EQ(eeprom.poll(), -7);
+    CHECK(eeprom.busy());
+    CHECK_EQ(device.getEEPROM(MLX90615_EEPROM_EMISSIVITY), 0x0000);
+
+    // Written on the next calls, without another erase
+    CHECK_EQ(eeprom.commit(), 0);
+    CHECK(!eeprom.busy());
+    CHECK_EQ(device.getEEPROM(MLX90615_EEPROM_EMISSIVITY), 0x3d70);
+    CHECK_EQ(eeprom.getWrites(), 1);
+
+    // commit() stops at the failure instead of spinning on a dead device
+    CHECK_EQ(eeprom.set(MLX90615_EEPROM_CONFIG, 0x24e9), 1);
+    while (eeprom.poll() == 1 && eeprom.phase() != MLX90615_EEPROM_WRITE);
+    device.injectNak(1);
+    CHECK_EQ(eeprom.commit(), -7);
+    CHECK(eeprom.busy());
+    CHECK_EQ(eeprom.commit(), 0);
+    CHECK_EQ(device.getEEPROM(MLX90615_EEPROM_CONFIG), 0x24e9);
+    bus.detach(&device);
+}
+
+static void testBatch() {
+    MLX90615Sim devices[3] = {MLX90615Sim(0x5C), MLX90615Sim(0x5D), MLX90615Sim(0x5E)};
+    MLX90615 mlx[3] = {MLX90615(0x5C, &bus), MLX90615(0x5D, &bus), MLX90615(0x5E, &bus)};
+    MLX90615Eeprom eeproms[3] = {MLX90615Eeprom(&mlx[0]), MLX90615Eeprom(&mlx[1]), MLX90615Eeprom(&mlx[2])};
+    MLX90615EepromBatch<3> batch;
+    for (int i = 0; i < 3; i++) {
+        bus.attach(&devices[i]);
+        eeproms[i].setClock(simMicros);
+        CHECK_EQ(eeproms[i].load(), 0);
+        CHECK_EQ(batch.add(&eeproms[i]), i);
+        eeproms[i].set(MLX90615_EEPROM_EMISSIVITY, 0x3d70);
+    }
+    CHECK_EQ(batch.add(&eeproms[0]), -1);
+    uint32_t t0 = bus.micros();
+    CHECK_EQ(batch.commit(), 0);
+    // Overlapped: one erase and one write wait, not three of each
+    CHECK(bus.micros() - t0 < 3 * MLX90615_EEPROM_WRITE_MS * 1000UL);
+    for (int i = 0; i < 3; i++) {
+        CHECK_EQ(devices[i].getEEPROM(MLX90615_EEPROM_EMISSIVITY), 0x3d70);
+        bus.detach(&devices[i]);
+    }
+}
+
+int main() {
+    TEST_RUN(testSetAndVerify);
+    TEST_RUN(testWriteFailsAfterErase);
+    TEST_RUN(testBatch);
+    return TEST_RESULT();
+}
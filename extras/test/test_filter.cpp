@@ -0,0 +1,116 @@
+/*
+    Raw value filters: moving average and running median against a brute
+    force over the same window, EMA steps and convergence, warm-up with
+    fewer samples than the window, and spike rejection.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615Filter.h>
+
+// Pseudo-random raw values around 15000, with spikes
+static uint16_t sample(uint16_t i) {
+    uint16_t noise = (uint16_t)(i * 7919u % 97);
+    return i % 13 == 5 ? 60000 : 15000 + noise;
+}
+
+static void testMovingAverage() {
+    MLX90615MovingAverage<4> average;
+    CHECK_EQ(average.value(), 0);
+    CHECK_EQ(average.update(100), 100);
+    CHECK_EQ(average.update(200), 150);
+    CHECK_EQ(average.update(300), 200);
+    CHECK_EQ(average.update(400), 250);
+    CHECK_EQ(average.update(500), 350);
+    CHECK_EQ(average.temperature<MLX90615_KELVIN_X50>(), MLX90615::rawToInt<MLX90615_KELVIN_X50>(350));
+
+    // Rounded to nearest
+    MLX90615MovingAverage<2> pair;
+    pair.update(1);
+    CHECK_EQ(pair.update(2), 2);
+
+    // Same as the mean of the last 8, over many turns of the window
+    MLX90615MovingAverage<8> window;
+    for (uint16_t i = 0; i < 500; i++) {
+        uint16_t value = window.update(sample(i));
+        uint8_t n = i < 8 ? i + 1 : 8;
+        uint32_t sum = 0;
+        for (uint8_t k = 0; k < n; k++) {
+            sum += sample(i - k);
+        }
+        CHECK_EQ(value, (sum + n / 2) / n);
+    }
+
+    // Full scale does not overflow the running sum
+    window.reset();
+    for (uint8_t i = 0; i < 20; i++) {
+        window.update(0xFFFF);
+    }
+    CHECK_EQ(window.value(), 0xFFFF);
+}
+
+static void testEma() {
+    MLX90615Ema<2> ema;
+    CHECK_EQ(ema.value(), 0);
+    CHECK_EQ(ema.update(1000), 1000);   // First sample primes the output
+    CHECK_EQ(ema.update(2000), 1250);
+    CHECK_EQ(ema.update(2000), 1438);
+    for (uint8_t i = 0; i < 50; i++) {
+        ema.update(2000);
+    }
+    CHECK_EQ(ema.value(), 2000);
+    ema.reset();
+    CHECK_EQ(ema.update(500), 500);
+
+    // Slowest coefficient at full scale
+    MLX90615Ema<15> slow;
+    CHECK_EQ(slow.update(0xFFFF), 0xFFFF);
+    CHECK_EQ(slow.update(0xFFFF), 0xFFFF);
+}
+
+static void testMedian() {
+    MLX90615Median<3> median;
+    CHECK_EQ(median.value(), 0);
+    CHECK_EQ(median.update(100), 100);
+    CHECK_EQ(median.update(5000), 100);
+    CHECK_EQ(median.update(102), 102);
+    CHECK_EQ(median.update(101), 102);
+    CHECK_EQ(median.update(103), 102);
+
+    // Same as sorting the last 5, over many turns of the window
+    MLX90615Median<5> window;
+    for (uint16_t i = 0; i < 500; i++) {
+        uint16_t value = window.update(sample(i));
+        uint8_t n = i < 5 ? i + 1 : 5;
+        uint16_t sorted[5];
+        for (uint8_t k = 0; k < n; k++) {
+            uint16_t v = sample(i - k);
+            uint8_t pos = k;
+            while (pos > 0 && sorted[pos - 1] > v) {
+                sorted[pos] = sorted[pos - 1];
+                pos--;
+            }
+            sorted[pos] = v;
+        }
+        CHECK_EQ(value, sorted[(n - 1) / 2]);
+        // Single sample spikes never reach the output
+        CHECK(value < 60000);
+    }
+}
+
+static void testChain() {
+    MLX90615Median<3> median;
+    MLX90615Ema<3> ema;
+    uint16_t value = 0;
+    for (uint16_t i = 0; i < 200; i++) {
+        value = ema.update(median.update(i % 10 == 3 ? 60000 : 15000));
+        CHECK_EQ(value, 15000);
+    }
+    CHECK_EQ(ema.temperature<MLX90615_CENTI_CELSIUS>(), MLX90615::rawToInt<MLX90615_CENTI_CELSIUS>(15000));
+}
+
+int main() {
+    TEST_RUN(testMovingAverage);
+    TEST_RUN(testEma);
+    TEST_RUN(testMedian);
+    TEST_RUN(testChain);
+    return TEST_RESULT();
+}
@@ -0,0 +1,103 @@
+/*
+    IIR setting: settling and noise figures against a direct simulation
+    of out += (in - out) / n, pick() against noise(), and the CONFIG bits
+    written through the EEPROM manager.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615Iir.h>
+#include <MLX90615Sim.h>
+
+static SimI2cMaster bus;
+
+static uint32_t simMicros() {
+    bus.advance(100);
+    return bus.micros();
+}
+
+static void testSettling() {
+    for (uint8_t n = 1; n <= MLX90615_IIR_MAX; n++) {
+        // Unit step, until within 1%
+        double out = 0;
+        uint8_t conversions = 0;
+        while (out < 0.99) {
+            out += (1 - out) / n;
+            conversions++;
+        }
+        CHECK_EQ(MLX90615Iir::settlingConversions(n), conversions);
+        CHECK_EQ(MLX90615Iir::settlingMs(n), conversions * MLX90615_CONVERSION_MS);
+    }
+    CHECK_EQ(MLX90615Iir::settlingConversions(0), 0);
+    CHECK_EQ(MLX90615Iir::settlingConversions(MLX90615_IIR_MAX + 1), 0);
+}
+
+static void testNoise() {
+    for (uint8_t n = 1; n <= MLX90615_IIR_MAX; n++) {
+        // White noise gain: rms of the impulse response
+        double a = 1.0 / n;
+        double power = 0;
+        double h = a;
+        for (int k = 0; k < 2000; k++) {
+            power += h * h;
+            h *= 1 - a;
+        }
+        float expected = 2.0 * sqrt(power);
+        float actual = MLX90615Iir::noise(n, 2.0);
+        CHECK(actual > expected * 0.9999 && actual < expected * 1.0001);
+    }
+    CHECK(MLX90615Iir::noise(0, 2.0) == 2.0);
+}
+
+static void testPick() {
+    CHECK_EQ(MLX90615Iir::pick(1.0, 1.0), 1);
+    CHECK_EQ(MLX90615Iir::pick(1.0, 2.0), 1);
+    CHECK_EQ(MLX90615Iir::pick(1.0, 0.01), MLX90615_IIR_MAX);
+    // The fastest setting within budget: the one before is over it
+    for (int step = 1; step <= 100; step++) {
+        float budget = step / 100.0;
+        uint8_t setting = MLX90615Iir::pick(1.0, budget);
+        CHECK(setting >= 1 && setting <= MLX90615_IIR_MAX);
+        if (setting < MLX90615_IIR_MAX) {
+            CHECK(MLX90615Iir::noise(setting, 1.0) <= budget * 1.0001);
+        }
+        if (setting > 1) {
+            CHECK(MLX90615Iir::noise(setting - 1, 1.0) > budget);
+        }
+    }
+}
+
+static void testSetting() {
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &bus);
+    bus.attach(&device);
+    MLX90615Eeprom eeprom(&mlx);
+    eeprom.setClock(simMicros);
+    MLX90615Iir iir(&eeprom);
+
+    uint8_t setting = 0;
+    CHECK_EQ(iir.getIir(&setting), -3);
+    CHECK_EQ(eeprom.load(), 0);
+    uint16_t config = device.getEEPROM(MLX90615_EEPROM_CONFIG);
+    CHECK_EQ(iir.getIir(&setting), 0);
+    CHECK_EQ(setting, (config & MLX90615_CONFIG_IIR_MASK) >> MLX90615_CONFIG_IIR_SHIFT);
+
+    CHECK_EQ(iir.setIir(0), -3);
+    CHECK_EQ(iir.setIir(MLX90615_IIR_MAX + 1), -3);
+    uint8_t other = setting == 2 ? 3 : 2;
+    CHECK_EQ(iir.setIir(other), 1);
+    CHECK_EQ(eeprom.commit(), 0);
+    CHECK_EQ(iir.getIir(&setting), 0);
+    CHECK_EQ(setting, other);
+    // Only the IIR bits changed
+    uint16_t written = device.getEEPROM(MLX90615_EEPROM_CONFIG);
+    CHECK_EQ(written & ~MLX90615_CONFIG_IIR_MASK, config & ~MLX90615_CONFIG_IIR_MASK);
+    CHECK_EQ((written & MLX90615_CONFIG_IIR_MASK) >> MLX90615_CONFIG_IIR_SHIFT, other);
+    bus.detach(&device);
+}
+
+int main() {
+    TEST_RUN(testSettling);
+    TEST_RUN(testNoise);
+    TEST_RUN(testPick);
+    TEST_RUN(testSetting);
+    return TEST_RESULT();
+}
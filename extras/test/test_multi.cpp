@@ -0,0 +1,107 @@
+/*
+    SoftI2cMultiMaster and MLX90615Multi on host pins (see SimPins.h):
+    one device per SDA lane, read in lockstep, with the result of each
+    bus kept apart when one of them fails.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615Multi.h>
+#include "SimPins.h"
+
+#define SCL_PIN 8
+#define BUSES   3
+
+static const uint8_t sdaPins[BUSES] = {3, 5, 7};
+
+static void testLockstep() {
+    SoftI2cMultiMaster i2c(sdaPins, BUSES, SCL_PIN);
+    MLX90615Sim devices[BUSES];
+    SimPins pins(SCL_PIN);
+    for (uint8_t i = 0; i < BUSES; i++) {
+        pins.addLane(sdaPins[i], &devices[i]);
+        devices[i].setRaw(MLX90615_OBJECT_TEMPERATURE, 15000 + i);
+    }
+    hostAttachPins(&pins);
+    MLX90615Multi mlx(MLX90615_DefaultAddr, &i2c);
+    CHECK_EQ(i2c.count(), BUSES);
+    CHECK_EQ(i2c.all(), 0x07);
+
+    // One pass: a reading per bus
+    uint16_t results[BUSES] = {0, 0, 0};
+    CHECK_EQ(mlx.readReg(MLX90615_OBJECT_TEMPERATURE, results), 0x07);
+    for (uint8_t i = 0; i < BUSES; i++) {
+        CHECK_EQ(results[i], 15000 + i);
+    }
+    int32_t centi[BUSES];
+    CHECK_EQ(mlx.getTemperatureInt<MLX90615_CENTI_CELSIUS>(MLX90615_OBJECT_TEMPERATURE, centi), 0x07);
+    CHECK_EQ(centi[0], MLX90615::rawToInt<MLX90615_CENTI_CELSIUS>(15000));
+    CHECK_EQ(centi[2], MLX90615::rawToInt<MLX90615_CENTI_CELSIUS>(15002));
+
+    // Bus 1 Naks, then sends a bad PEC: only its bit drops, its result
+    // is left untouched, the others are read
+    for (uint8_t i = 0; i < BUSES; i++) {
+        devices[i].setRaw(MLX90615_OBJECT_TEMPERATURE, 16000 + i);
+    }
+    devices[1].injectNak(1);
+    CHECK_EQ(mlx.readReg(MLX90615_OBJECT_TEMPERATURE, results), 0x05);
+    CHECK_EQ(results[0], 16000);
+    CHECK_EQ(results[1], 15001);
+    CHECK_EQ(results[2], 16002);
+    devices[1].injectBadPec(1);
+    CHECK_EQ(mlx.readReg(MLX90615_OBJECT_TEMPERATURE, results), 0x05);
+    CHECK_EQ(results[1], 15001);
+    CHECK_EQ(mlx.readReg(MLX90615_OBJECT_TEMPERATURE, results), 0x07);
+    CHECK_EQ(results[1], 16001);
+    hostAttachPins(0);
+}
+
+static void testMissingDevice() {
+    SoftI2cMultiMaster i2c(sdaPins, BUSES, SCL_PIN);
+    MLX90615Sim devices[2];
+    SimPins pins(SCL_PIN);
+    pins.addLane(sdaPins[0], &devices[0]);
+    pins.addLane(sdaPins[1], 0);
+    pins.addLane(sdaPins[2], &devices[1]);
+    devices[0].setRaw(MLX90615_AMBIENT_TEMPERATURE, 14000);
+    devices[1].setRaw(MLX90615_AMBIENT_TEMPERATURE, 14002);
+    hostAttachPins(&pins);
+    MLX90615Multi mlx(MLX90615_DefaultAddr, &i2c);
+
+    uint16_t results[BUSES] = {0, 0xAAAA, 0};
+    CHECK_EQ(mlx.readReg(MLX90615_AMBIENT_TEMPERATURE, results), 0x05);
+    CHECK_EQ(results[0], 14000);
+    CHECK_EQ(results[1], 0xAAAA);
+    CHECK_EQ(results[2], 14002);
+    hostAttachPins(0);
+}
+
+static void testLimits() {
+    // No bus: taken as one, never the uninitialised pins
+    SoftI2cMultiMaster none(sdaPins, 0, SCL_PIN);
+    CHECK_EQ(none.count(), 1);
+    CHECK_EQ(none.all(), 0x01);
+
+    // A clock of 0 is the slowest, 255 us per half bit
+    SoftI2cMultiMaster i2c(sdaPins, 1, SCL_PIN, 0);
+    MLX90615Sim device;
+    SimPins pins(SCL_PIN);
+    pins.addLane(sdaPins[0], &device);
+    hostAttachPins(&pins);
+    hostRealTime(false);
+    MLX90615Multi mlx(MLX90615_DefaultAddr, &i2c);
+    uint16_t result;
+    CHECK_EQ(mlx.readReg(MLX90615_OBJECT_TEMPERATURE, &result), 0x01);
+    CHECK_EQ(pins.minPeriod, 510);
+    i2c.setClock(100000);
+    pins.resetTiming();
+    CHECK_EQ(mlx.readReg(MLX90615_OBJECT_TEMPERATURE, &result), 0x01);
+    CHECK_EQ(pins.minPeriod, 10);
+    hostRealTime(true);
+    hostAttachPins(0);
+}
+
+int main() {
+    TEST_RUN(testLockstep);
+    TEST_RUN(testMissingDevice);
+    TEST_RUN(testLimits);
+    return TEST_RESULT();
+}
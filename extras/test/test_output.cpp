@@ -0,0 +1,57 @@
+/*
+    Output cells: relay switching points on the rounded PWMT_MIN grid.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615Output.h>
+#include <MLX90615Sim.h>
+
+static SimI2cMaster bus;
+
+static uint32_t simMicros() {
+    bus.advance(100);
+    return bus.micros();
+}
+
+static void testRelay() {
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &bus);
+    MLX90615Eeprom eeprom(&mlx);
+    MLX90615Output output(&eeprom);
+    bus.attach(&device);
+    eeprom.setClock(simMicros);
+    CHECK_EQ(eeprom.load(), 0);
+
+    // On at 15700 rounded down to 15616, off still at 15700 - 100
+    uint16_t min = 0, range = 0;
+    CHECK_EQ(output.setRelay<MLX90615_KELVIN_X50>(15700, 100), 1);
+    CHECK_EQ(eeprom.commit(), 0);
+    CHECK_EQ(output.getRawScale(&min, &range), 0);
+    CHECK_EQ(min, 15616);
+    CHECK_EQ(min - range, 15600);
+    // The slave address bits are kept
+    CHECK_EQ(device.getEEPROM(MLX90615_EEPROM_SA) & (MLX90615_PWMT_MIN_STEP - 1), MLX90615_DefaultAddr);
+
+    // Hysteresis smaller than the rounding: no hysteresis left
+    CHECK_EQ(output.setRelay<MLX90615_KELVIN_X50>(15700, 50), 1);
+    CHECK_EQ(eeprom.commit(), 0);
+    CHECK_EQ(output.getRawScale(&min, &range), 0);
+    CHECK_EQ(min, 15616);
+    CHECK_EQ(range, 0);
+
+    // Celsius: off at 30.00 °C whatever the rounding of the 40.00 °C threshold
+    int32_t on, off;
+    CHECK_EQ(output.setRelay<MLX90615_CENTI_CELSIUS>(4000, 1000), 1);
+    CHECK_EQ(eeprom.commit(), 0);
+    CHECK_EQ(output.getRawScale(&min, &range), 0);
+    on = MLX90615::rawToInt<MLX90615_CENTI_CELSIUS>(min);
+    off = MLX90615::rawToInt<MLX90615_CENTI_CELSIUS>(min - range);
+    CHECK(on <= 4000 && on > 4000 - 256);
+    CHECK(off >= 2999 && off <= 3001);
+    CHECK_EQ(output.setRelay<MLX90615_CENTI_CELSIUS>(4000, -1), -3);
+    bus.detach(&device);
+}
+
+int main() {
+    TEST_RUN(testRelay);
+    return TEST_RESULT();
+}
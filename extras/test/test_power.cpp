@@ -0,0 +1,52 @@
+/*
+    Duty cycle: wake-up, settling and the discarded reading are done
+    ahead of the schedule, so each read is returned when it is due.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615Power.h>
+#include <MLX90615Sim.h>
+
+static SimI2cMaster bus;
+
+static uint32_t simMicros() {
+    return bus.micros();
+}
+
+static void testOnTime() {
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &bus);
+    bus.attach(&device);
+    MLX90615DutyCycle power(&mlx, 2000);
+    power.setClock(simMicros);
+
+    MLX90615Data data = {};
+    int samples = 0;
+    uint32_t start = bus.micros();
+    while (bus.micros() - start < 20000000UL) {
+        uint32_t before = bus.micros();
+        // A new value each ms, so any read into data would show
+        device.setRaw(MLX90615_OBJECT_TEMPERATURE, 15000 + (before / 1000) % 1000);
+        MLX90615Data last = data;
+        int status = power.poll(&data);
+        if (!status) {
+            // Skipped settling reads never reach the caller's sample
+            CHECK_EQ(data.object, last.object);
+        }
+        if (status) {
+            CHECK_EQ(status, 1);
+            CHECK(data.object != 0);
+            // Read at the first poll() once due: latency is (about) the poll() itself
+            CHECK((int32_t)(power.latency() - (bus.micros() - before)) < 1000);
+            samples++;
+        }
+        bus.advance(1000);
+    }
+    CHECK_EQ(samples, 10);
+    CHECK(power.duty() < 0.25);
+    bus.detach(&device);
+}
+
+int main() {
+    TEST_RUN(testOnTime);
+    return TEST_RESULT();
+}
@@ -0,0 +1,111 @@
+/*
+    Sample ring: wrap-around of the free running indexes, a full ring
+    dropping and counting samples, drain() in batches; acquisition with
+    the sample stamped when its transfer completed.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615Ring.h>
+#include <MLX90615Sim.h>
+
+static MLX90615Sample make(uint16_t value) {
+    MLX90615Sample sample;
+    sample.timestamp = value * 10;
+    sample.value = value;
+    sample.device = 0;
+    sample.reg = MLX90615_OBJECT_TEMPERATURE;
+    sample.status = 0;
+    return sample;
+}
+
+static void testRing() {
+    MLX90615Ring<8> ring;
+    MLX90615Sample out[8];
+    CHECK_EQ(ring.available(), 0);
+    CHECK_EQ(ring.drain(out, 8), 0);
+
+    // 300 samples through 3 at a time: the uint8_t indexes wrap
+    uint16_t expected = 0;
+    for (uint16_t value = 0; value < 300; value += 3) {
+        for (uint16_t i = 0; i < 3; i++) {
+            CHECK(ring.push(make(value + i)));
+        }
+        CHECK_EQ(ring.available(), 3);
+        CHECK_EQ(ring.drain(out, 8), 3);
+        for (uint8_t i = 0; i < 3; i++) {
+            CHECK_EQ(out[i].value, expected);
+            CHECK_EQ(out[i].timestamp, expected * 10);
+            expected++;
+        }
+    }
+
+    // Full: the newest samples are dropped, the queued ones kept
+    for (uint16_t i = 0; i < 8; i++) {
+        CHECK(ring.push(make(1000 + i)));
+    }
+    CHECK(!ring.push(make(2000)));
+    CHECK(!ring.push(make(2001)));
+    CHECK_EQ(ring.available(), 8);
+    CHECK_EQ(ring.getOverruns(), 2);
+
+    // drain(max): oldest first, at most max, the rest left queued
+    CHECK_EQ(ring.drain(out, 5), 5);
+    CHECK_EQ(out[0].value, 1000);
+    CHECK_EQ(out[4].value, 1004);
+    CHECK_EQ(ring.available(), 3);
+    CHECK(ring.push(make(1008)));
+    CHECK_EQ(ring.drain(out, 8), 4);
+    CHECK_EQ(out[0].value, 1005);
+    CHECK_EQ(out[3].value, 1008);
+    CHECK_EQ(ring.available(), 0);
+    CHECK_EQ(ring.getOverruns(), 2);
+}
+
+static void testAcquisition() {
+    SimI2cMaster bus;
+    MLX90615Sim devices[2] = {MLX90615Sim(0x5B), MLX90615Sim(0x5C)};
+    MLX90615 mlx[2] = {MLX90615(0x5B, &bus), MLX90615(0x5C, &bus)};
+    MLX90615Acquisition<2, 8> acquisition;
+    I2cAsync engine(&bus);
+    for (int i = 0; i < 2; i++) {
+        bus.attach(&devices[i]);
+        devices[i].setRaw(MLX90615_OBJECT_TEMPERATURE, 15000 + i);
+        CHECK_EQ(acquisition.add(&mlx[i]), i);
+    }
+
+    // Blocking: one channel per call, in turn
+    MLX90615Sample out[8];
+    acquisition.service();
+    acquisition.service();
+    acquisition.service();
+    CHECK_EQ(acquisition.ring.drain(out, 8), 3);
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK_EQ(out[i].device, i % 2);
+        CHECK_EQ(out[i].status, 0);
+        CHECK_EQ(out[i].value, 15000 + i % 2);
+    }
+
+    // Async: stamped on completion, even if collected much later
+    hostRealTime(false);
+    CHECK(!acquisition.serviceAsync(&engine));
+    while (engine.poll());
+    uint32_t completed = micros();
+    delayMicroseconds(5000);
+    CHECK(acquisition.serviceAsync(&engine));
+    while (engine.poll());
+    CHECK(acquisition.serviceAsync(&engine));
+    CHECK_EQ(acquisition.ring.drain(out, 8), 2);
+    CHECK_EQ(out[0].timestamp, completed);
+    CHECK_EQ(out[1].timestamp, completed + 5000);
+    for (uint8_t i = 0; i < 2; i++) {
+        CHECK_EQ(out[i].status, 0);
+        CHECK_EQ(out[i].value, 15000 + out[i].device);
+    }
+    CHECK(out[0].device != out[1].device);
+    hostRealTime(true);
+}
+
+int main() {
+    TEST_RUN(testRing);
+    TEST_RUN(testAcquisition);
+    return TEST_RESULT();
+}
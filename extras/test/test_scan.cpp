@@ -0,0 +1,99 @@
+/*
+    Scanner: the devices found, over any range, with and without the
+    quick probe. Provisioner: addresses given through the general
+    address, reserved ones refused, and the end of the range.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615Scan.h>
+#include <MLX90615Sim.h>
+
+static SimI2cMaster bus;
+
+// Every EEPROM wait lets some simulated time pass
+static uint32_t simMicros() {
+    bus.advance(100);
+    return bus.micros();
+}
+
+static void testScan() {
+    MLX90615Sim devices[3] = {MLX90615Sim(0x10), MLX90615Sim(0x5B), MLX90615Sim(0x77)};
+    for (int i = 0; i < 3; i++) {
+        bus.attach(&devices[i]);
+    }
+    MLX90615Scanner scanner(&bus);
+    uint8_t found[4];
+    CHECK_EQ(scanner.scan(found, 4), 3);
+    CHECK_EQ(found[0], 0x10);
+    CHECK_EQ(found[1], 0x5B);
+    CHECK_EQ(found[2], 0x77);
+    CHECK_EQ(scanner.getReads(), MLX90615_SCAN_LAST - MLX90615_SCAN_FIRST + 1);
+    CHECK_EQ(scanner.getProbes(), 0);
+
+    // Only the first max stored, all counted
+    CHECK_EQ(scanner.scan(found, 1), 3);
+    CHECK_EQ(found[0], 0x10);
+
+    // Up to the last address: the loop ends, no address wraps around
+    CHECK_EQ(scanner.scan(found, 4, 0x50, 0xFF), 2);
+    CHECK_EQ(found[0], 0x5B);
+    CHECK_EQ(found[1], 0x77);
+
+    // Quick probe: a PEC read only where an address is acked
+    MLX90615Scanner quick(&bus);
+    quick.setQuickProbe(true);
+    CHECK_EQ(quick.scan(found, 4), 3);
+    CHECK_EQ(quick.getProbes(), MLX90615_SCAN_LAST - MLX90615_SCAN_FIRST + 1);
+    CHECK_EQ(quick.getReads(), 3);
+
+    uint16_t sa = 0;
+    CHECK_EQ(scanner.identify(0x5B, &sa), 0);
+    CHECK_EQ(sa & 0x7F, 0x5B);
+    CHECK_EQ(scanner.identify(0x5C), -2);
+    for (int i = 0; i < 3; i++) {
+        bus.detach(&devices[i]);
+    }
+}
+
+static void testProvision() {
+    MLX90615Sim device;
+    bus.attach(&device);
+    MLX90615Provisioner provisioner(&bus, 0x76, 0x77);
+    provisioner.setClock(simMicros);
+    CHECK(provisioner.present());
+
+    // Reserved or not 7-bit: refused before anything is written
+    uint8_t refused[6] = {0x00, 0x03, 0x07, 0x78, 0x7F, 0x80};
+    for (int i = 0; i < 6; i++) {
+        CHECK_EQ(provisioner.provision(refused[i]), -3);
+        CHECK_EQ(device.getEEPROM(MLX90615_EEPROM_SA) & 0x7F, MLX90615_DefaultAddr);
+    }
+
+    CHECK_EQ(provisioner.provision(0x08), 0);
+    CHECK_EQ(device.getEEPROM(MLX90615_EEPROM_SA) & 0x7F, 0x08);
+
+    // The range, then its end
+    uint8_t assigned = 0;
+    CHECK_EQ(provisioner.provisionNext(&assigned), 0);
+    CHECK_EQ(assigned, 0x76);
+    CHECK_EQ(device.getEEPROM(MLX90615_EEPROM_SA) & 0x7F, 0x76);
+    CHECK_EQ(provisioner.provisionNext(&assigned), 0);
+    CHECK_EQ(assigned, 0x77);
+    CHECK_EQ(provisioner.provisionNext(&assigned), -6);
+
+    // A range running into the reserved addresses stops there
+    MLX90615Provisioner beyond(&bus, 0x78, 0x7A);
+    beyond.setClock(simMicros);
+    CHECK_EQ(beyond.provisionNext(&assigned), -3);
+    CHECK_EQ(assigned, 0x77);
+    bus.detach(&device);
+
+    // Nobody on the bus
+    CHECK(!provisioner.present());
+    CHECK_EQ(provisioner.provision(0x20), -2);
+}
+
+int main() {
+    TEST_RUN(testScan);
+    TEST_RUN(testProvision);
+    return TEST_RESULT();
+}
@@ -0,0 +1,77 @@
+/*
+    FastSoftI2cMaster on host pins (see SimPins.h): the waveform decodes
+    to correct transactions, and the SCL timing follows setClock().
+*/
+#include "MLX90615Test.h"
+#include <MLX90615.h>
+#include "SimPins.h"
+
+#define SDA_PIN 4
+#define SCL_PIN 5
+
+static void testWaveform() {
+    FastSoftI2cMaster i2c(SDA_PIN, SCL_PIN);
+    MLX90615Sim device;
+    SimPins pins(SCL_PIN);
+    pins.addLane(SDA_PIN, &device);
+    hostAttachPins(&pins);
+    MLX90615 mlx(MLX90615_DefaultAddr, &i2c);
+    MLX90615 nobody(0x5A, &i2c);
+    nobody.setRetries(0);
+    device.setRaw(MLX90615_OBJECT_TEMPERATURE, 15488);
+    device.setRaw(MLX90615_AMBIENT_TEMPERATURE, 0x3AF7);
+
+    uint16_t value = 0;
+    CHECK_EQ(mlx.readReg(MLX90615_OBJECT_TEMPERATURE, &value), 0);
+    CHECK_EQ(value, 15488);
+    MLX90615Data data = {};
+    CHECK_EQ(mlx.readAll(&data), 0);
+    CHECK_EQ(data.ambient, 0x3AF7);
+    CHECK_EQ(data.object, 15488);
+    CHECK_EQ(nobody.readReg(MLX90615_OBJECT_TEMPERATURE, &value), -2);
+
+    // A write goes through with a good PEC
+    CHECK_EQ(mlx.writeReg(MLX90615_EEPROM_EMISSIVITY, 0x0000), 0);
+    CHECK_EQ(device.getEEPROM(MLX90615_EEPROM_EMISSIVITY), 0x0000);
+    hostAttachPins(0);
+}
+
+// SCL high and low times of one register read at sclHz
+static void checkClock(FastSoftI2cMaster* i2c, MLX90615* mlx, SimPins* pins,
+                       uint32_t sclHz, uint32_t halfUs) {
+    i2c->setClock(sclHz);
+    pins->resetTiming();
+    uint16_t value;
+    CHECK_EQ(mlx->readReg(MLX90615_OBJECT_TEMPERATURE, &value), 0);
+    CHECK_EQ(pins->minHigh, halfUs);
+    CHECK_EQ(pins->minLow, halfUs);
+    CHECK_EQ(pins->minPeriod, 2 * halfUs);
+    // Rounded down: never faster than asked, down to the slowest clock
+    CHECK(sclHz < 1961 || pins->minPeriod * sclHz >= 1000000UL);
+}
+
+static void testClock() {
+    FastSoftI2cMaster i2c(SDA_PIN, SCL_PIN);
+    MLX90615Sim device;
+    SimPins pins(SCL_PIN);
+    pins.addLane(SDA_PIN, &device);
+    hostAttachPins(&pins);
+    MLX90615 mlx(MLX90615_DefaultAddr, &i2c);
+    hostRealTime(false);
+
+    checkClock(&i2c, &mlx, &pins, 100000, 5);
+    checkClock(&i2c, &mlx, &pins, 400000, 2);   // 1.25 us rounded up: 250 kHz
+    checkClock(&i2c, &mlx, &pins, 1000000, 1);
+    checkClock(&i2c, &mlx, &pins, 3000, 167);
+    checkClock(&i2c, &mlx, &pins, 1961, 255);   // Slowest
+    checkClock(&i2c, &mlx, &pins, 1000, 255);
+    checkClock(&i2c, &mlx, &pins, 0, 255);      // Not a division by zero
+    hostRealTime(true);
+    hostAttachPins(0);
+}
+
+int main() {
+    TEST_RUN(testWaveform);
+    TEST_RUN(testClock);
+    return TEST_RESULT();
+}
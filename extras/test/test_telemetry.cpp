@@ -0,0 +1,130 @@
+/*
+    Telemetry frames: encoder to decoder round trips, device bitmap
+    changes, lost and corrupted frames.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615Telemetry.h>
+
+#define DEVICES 4
+#define ALL_FIELDS (MLX90615_FIELD_RAW_IR | MLX90615_FIELD_AMBIENT | MLX90615_FIELD_OBJECT)
+
+// Noisy readings with a drift and the odd full scale jump
+static void sample(MLX90615Data* samples, uint16_t i) {
+    for (uint8_t dev = 0; dev < DEVICES; dev++) {
+        samples[dev].rawIr = (uint16_t)(0x8000 + dev * 300 - (i * 37 % 101));
+        samples[dev].ambient = 14908 + dev + i / 20;
+        samples[dev].object = i % 97 == 0 ? 0x7FFF : 15488 + (i * 7 % 5) + i / 10 - dev;
+    }
+}
+
+static bool same(const MLX90615Data* a, const MLX90615Data* b, uint8_t fields) {
+    return (!(fields & MLX90615_FIELD_RAW_IR) || a->rawIr == b->rawIr) &&
+           (!(fields & MLX90615_FIELD_AMBIENT) || a->ambient == b->ambient) &&
+           (!(fields & MLX90615_FIELD_OBJECT) || a->object == b->object);
+}
+
+static void testRoundTrip() {
+    const uint8_t masks[] = {MLX90615_FIELD_OBJECT, MLX90615_FIELD_AMBIENT | MLX90615_FIELD_OBJECT, ALL_FIELDS};
+    for (uint8_t m = 0; m < sizeof(masks); m++) {
+        MLX90615TelemetryEncoder<DEVICES> encoder(masks[m], 8);
+        MLX90615TelemetryDecoder<DEVICES> decoder;
+        MLX90615Data samples[DEVICES];
+        MLX90615Data received[DEVICES] = {};
+        uint8_t frame[MLX90615_TELEMETRY_MAX_FRAME(3 * DEVICES)];
+        uint16_t mismatches = 0;
+        uint16_t failures = 0;
+        for (uint16_t i = 0; i < 500; i++) {
+            sample(samples, i);
+            uint8_t len = encoder.encode(samples, 0x0F, frame, sizeof(frame));
+            uint8_t present = 0;
+            if (decoder.decode(frame, len, received, &present) != len || present != 0x0F) {
+                failures++;
+                continue;
+            }
+            for (uint8_t dev = 0; dev < DEVICES; dev++) {
+                mismatches += !same(&received[dev], &samples[dev], masks[m]);
+            }
+        }
+        CHECK_EQ(failures, 0);
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(decoder.getLost(), 0);
+    }
+}
+
+static void testDeviceJoins() {
+    MLX90615TelemetryEncoder<DEVICES> encoder(ALL_FIELDS, 16);
+    MLX90615TelemetryDecoder<DEVICES> decoder;
+    MLX90615Data samples[DEVICES];
+    MLX90615Data received[DEVICES] = {};
+    uint8_t frame[MLX90615_TELEMETRY_MAX_FRAME(3 * DEVICES)];
+    uint8_t present = 0;
+
+    // Devices 0 and 1 only, then 2 and 3 join in a frame that would be a delta
+    const uint8_t bitmaps[] = {0x03, 0x03, 0x03, 0x0F, 0x0F, 0x0B, 0x0F, 0x0F};
+    for (uint8_t i = 0; i < sizeof(bitmaps); i++) {
+        sample(samples, i);
+        uint8_t len = encoder.encode(samples, bitmaps[i], frame, sizeof(frame));
+        CHECK(len > 0);
+        CHECK_EQ(decoder.decode(frame, len, received, &present), len);
+        CHECK_EQ(present, bitmaps[i]);
+        for (uint8_t dev = 0; dev < DEVICES; dev++) {
+            if (bitmaps[i] & (1 << dev)) {
+                CHECK(same(&received[dev], &samples[dev], ALL_FIELDS));
+            }
+        }
+        // Joining forces a keyframe, staying or coming back does not
+        bool keyframe = frame[1] & MLX90615_TELEMETRY_KEYFRAME;
+        CHECK_EQ(keyframe, i == 0 || i == 3);
+    }
+}
+
+static void testLostFrame() {
+    MLX90615TelemetryEncoder<DEVICES> encoder(ALL_FIELDS, 4);
+    MLX90615TelemetryDecoder<DEVICES> decoder;
+    MLX90615Data samples[DEVICES];
+    MLX90615Data received[DEVICES] = {};
+    uint8_t frame[MLX90615_TELEMETRY_MAX_FRAME(3 * DEVICES)];
+    uint8_t present = 0;
+
+    for (uint16_t i = 0; i < 12; i++) {
+        sample(samples, i);
+        uint8_t len = encoder.encode(samples, 0x0F, frame, sizeof(frame));
+        if (i == 1) {
+            continue;   // Lost on the link
+        }
+        int status = decoder.decode(frame, len, received, &present);
+        // Deltas are dropped until the keyframe of frame 4
+        CHECK_EQ(status, i == 2 || i == 3 ? -4 : len);
+        if (status > 0) {
+            CHECK(same(&received[3], &samples[3], ALL_FIELDS));
+        }
+    }
+    CHECK_EQ(decoder.getLost(), 1);
+}
+
+static void testCorruptFrame() {
+    MLX90615TelemetryEncoder<DEVICES> encoder;
+    MLX90615TelemetryDecoder<DEVICES> decoder;
+    MLX90615Data samples[DEVICES];
+    MLX90615Data received[DEVICES] = {};
+    uint8_t frame[MLX90615_TELEMETRY_MAX_FRAME(3 * DEVICES)];
+    uint8_t present = 0;
+
+    sample(samples, 0);
+    uint8_t len = encoder.encode(samples, 0x0F, frame, sizeof(frame));
+    frame[6] ^= 0x01;
+    CHECK_EQ(decoder.decode(frame, len, received, &present), -1);
+    frame[6] ^= 0x01;
+    CHECK_EQ(decoder.decode(frame, len - 1, received, &present), -3);
+    CHECK_EQ(decoder.decode(frame, len, received, &present), len);
+    // Too small an output buffer
+    CHECK_EQ(encoder.encode(samples, 0x0F, frame, MLX90615_TELEMETRY_HEADER + 2), 0);
+}
+
+int main() {
+    TEST_RUN(testRoundTrip);
+    TEST_RUN(testDeviceJoins);
+    TEST_RUN(testLostFrame);
+    TEST_RUN(testCorruptFrame);
+    return TEST_RESULT();
+}
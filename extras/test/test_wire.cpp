@@ -0,0 +1,272 @@
+/*
+    Driver on the Arduino Wire API, through SimWire: the same simulated
+    devices and transaction shapes as the I2cMasterBase path.
+*/
+#include "MLX90615Test.h"
+#include <MLX90615.h>
+#include "SimWire.h"
+
+static void testWireReadReg() {
+    SimI2cMaster bus;
+    SimWire wire(&bus);
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &wire);
+    bus.attach(&device);
+    device.setTemperature(MLX90615_OBJECT_TEMPERATURE, 36.6);
+
+    uint16_t value = 0;
+    CHECK_EQ(mlx.readReg(MLX90615_OBJECT_TEMPERATURE, &value), 0);
+    CHECK_EQ(value, 15488);
+    CHECK_STR(bus.shape(), "SAWRArrnP");
+
+    MLX90615Data data;
+    CHECK_EQ(mlx.readAll(&data), 0);
+    CHECK_EQ(data.object, 15488);
+    CHECK_STR(bus.shape(), "SAWRArrnRAWRArrnRAWRArrnP");
+}
+
+static void testWireWriteReg() {
+    SimI2cMaster bus;
+    SimWire wire(&bus);
+    MLX90615Sim device;
+    MLX90615 mlx(MLX90615_DefaultAddr, &wire);
+    bus.attach(&device);
+
+    CHECK_EQ(mlx.writeReg(MLX90615_EEPROM_EMISSIVITY, 0x0000), 0);
+    CHECK_STR(bus.shape(), "SAWWWWP");
+    bus.advance(MLX90615_SIM_EEPROM_WRITE_US);
+    CHECK_EQ(mlx.writeReg(MLX90615_EEPROM_EMISSIVITY, 0x3d70), 0);
+    bus.advance(MLX90615_SIM_EEPROM_WRITE_US);
+    CHECK_EQ(device.getEEPROM(MLX90615_EEPROM_EMISSIVITY), 0x3d70);
+}
+
+static void testWireNak() {
+    SimI2cMaster bus;
+    SimWire wire(&bus);
+    MLX90615Sim device;
+    MLX90615 nobody(0x5A, &wire);
+    bus.attach(&device);
+    nobody.setRetries(0);
+
+    uint16_t value;
+    CHECK_EQ(nobody.readReg(MLX90615_OBJECT_TEMPERATURE, &value), -2);
+    CHECK_STR(bus.shape(), "SNP");
+    CHECK_EQ(nobody.probe(), -2);
+}
+
+static void testTwiMaster() {
+    SimI2cMaster bus;
+    SimWire wire(&bus);
+    MLX90615Sim device;
+    TwiMaster twi(wire);
+    MLX90615 mlx(MLX90615_DefaultAddr, &twi);
+    MLX90615T<MLX90615TwiTransport> mlxT(MLX90615_DefaultAddr, &twi);
+    bus.attach(&device);
+    device.setRaw(MLX90615_OBJECT_TEMPERATURE, 15488);
+
+    // One write burst, a repeated start and one read burst
+    uint16_t value = 0;
+    CHECK_EQ(mlx.readReg(MLX90615_OBJECT_TEMPERATURE, &value), 0);
+    CHECK_EQ(value, 15488);
+    CHECK_STR(bus.shape(), "SAWRArrnP");
+    value = 0;
+    CHECK_EQ(mlxT.readReg(MLX90615_OBJECT_TEMPERATURE, &value), 0);
+    CHECK_EQ(value, 15488);
+    CHECK_STR(bus.shape(), "SAWRArrnP");
+    MLX90615Data data;
+    CHECK_EQ(mlx.readAll(&data), 0);
+    CHECK_EQ(data.object, 15488);
+    CHECK_STR(bus.shape(), "SAWRArrnRAWRArrnRAWRArrnP");
+    CHECK_EQ(mlxT.writeReg(MLX90615_EEPROM_EMISSIVITY, 0x0000), 0);
+    CHECK_STR(bus.shape(), "SAWWWWP");
+    bus.advance(MLX90615_SIM_EEPROM_WRITE_US);
+    CHECK_EQ(wire.begins(), 1);
+    CHECK_EQ(wire.clock(), F_TWI);
+
+    // Not the ambiguous TwiMaster(0) any more: pull-up flag, default Wire
+    TwiMaster noPullups(0);
+    (void)noPullups;
+}
+
+static void testTwiMasterAsync() {
+    SimI2cMaster bus;
+    SimWire wire(&bus);
+    MLX90615Sim devices[2] = {MLX90615Sim(0x5C), MLX90615Sim(0x5D)};
+    TwiMaster twi(wire);
+    MLX90615 mlx[2] = {MLX90615(0x5C, &twi), MLX90615(0x5D, &twi)};
+    MLX90615 nobody(0x5A, &twi);
+    I2cAsync engine(&twi);
+    MLX90615AsyncRead requests[3] = {};
+    for (int i = 0; i < 2; i++) {
+        bus.attach(&devices[i]);
+        devices[i].setRaw(MLX90615_OBJECT_TEMPERATURE, 15000 + i);
+        CHECK_EQ(mlx[i].readRegAsync(&engine, MLX90615_OBJECT_TEMPERATURE, &requests[i]), 0);
+    }
+    CHECK_EQ(nobody.readRegAsync(&engine, MLX90615_OBJECT_TEMPERATURE, &requests[2]), 0);
+
+    // Each read is one burst, not a message per byte
+    I2cBusStats before = bus.stats();
+    while (engine.poll());
+    I2cBusStats d = bus.stats() - before;
+    CHECK_EQ(d.transactions, 3);
+    CHECK_EQ(d.restarts, 2);
+    uint16_t value;
+    for (int i = 0; i < 2; i++) {
+        CHECK_EQ(MLX90615::readRegResult(&requests[i], &value), 0);
+        CHECK_EQ(value, 15000 + i);
+    }
+    CHECK_EQ(MLX90615::readRegResult(&requests[2], &value), I2C_NAK);
+    CHECK_STR(bus.shape(), "SNP");
+}
+
+static void testWireRelease() {
+    SimI2cMaster bus;
+    SimWire wire(&bus);
+    MLX90615Sim device;
+    TwiMaster twi(wire);
+    MLX90615 wired(MLX90615_DefaultAddr, &wire);
+    MLX90615 mlx(MLX90615_DefaultAddr, &twi);
+    bus.attach(&device);
+    wired.setRetries(0);
+    mlx.setRetries(0);
+
+    // A bad PEC in the first word of readAll kept the bus: the session
+    // must still end with a stop, not wait for the next message
+    MLX90615Data data;
+    device.injectBadPec(1);
+    CHECK_EQ(wired.readAll(&data), -1);
+    CHECK_STR(bus.shape(), "SAWRArrnRAP");
+    device.injectBadPec(1);
+    CHECK_EQ(mlx.readAll(&data), -1);
+    CHECK_STR(bus.shape(), "SAWRArrnRAP");
+
+    // Next session opens with a start again
+    uint16_t value;
+    CHECK_EQ(wired.readReg(MLX90615_OBJECT_TEMPERATURE, &value), 0);
+    CHECK_STR(bus.shape(), "SAWRArrnP");
+}
+
+// Records the Wire state when SCL is first driven low
+class SclProbe : public HostPins {
+
+  public:
+    TwoWire* wire;
+    bool low;
+    uint16_t endsWhenLow;
+    uint16_t beginsWhenLow;
+
+    explicit SclProbe(TwoWire* i2c) : wire(i2c), low(false), endsWhenLow(0), beginsWhenLow(0) {}
+
+    void changed(uint8_t pin) {
+        bool now = hostDrivesLow(PIN_WIRE_SCL);
+        if (pin == PIN_WIRE_SCL && now && !low) {
+            endsWhenLow = wire->ends();
+            beginsWhenLow = wire->begins();
+        }
+        low = now;
+    }
+};
+
+static void checkWake(MLX90615* mlx, TwoWire* wire) {
+    SclProbe probe(wire);
+    hostAttachPins(&probe);
+    uint16_t ends = wire->ends();
+    uint16_t begins = wire->begins();
+    // Wire ended first: the peripheral would keep the pin otherwise
+    mlx->beginWake();
+    CHECK(probe.low);
+    CHECK_EQ(probe.endsWhenLow, ends + 1);
+    CHECK_EQ(probe.beginsWhenLow, begins);
+    CHECK_EQ(digitalRead(PIN_WIRE_SCL), LOW);
+    mlx->endWake();
+    CHECK(!probe.low);
+    CHECK_EQ(digitalRead(PIN_WIRE_SCL), HIGH);
+    CHECK_EQ(wire->begins(), begins + 1);
+    hostAttachPins(0);
+}
+
+static void testWireWake() {
+    SimI2cMaster bus;
+    SimWire wire(&bus);
+    TwiMaster twi(wire);
+    MLX90615 wired(MLX90615_DefaultAddr, &wire);
+    MLX90615 mlx(MLX90615_DefaultAddr, &twi);
+
+    checkWake(&wired, &wire);
+    uint16_t value;
+    mlx.readReg(MLX90615_OBJECT_TEMPERATURE, &value);
+    checkWake(&mlx, &wire);
+}
+
+// A slave holding SDA low for some SCL pulses; records the Wire state
+// when either pin is first touched
+class StuckSda : public HostPins {
+
+  public:
+    TwoWire* wire;
+    uint8_t clocks;
+    bool touched;
+    uint16_t endsWhenTouched;
+
+    StuckSda(TwoWire* i2c, uint8_t pulses) : wire(i2c), clocks(pulses), touched(false), endsWhenTouched(0) {}
+
+    void changed(uint8_t pin) {
+        if (!touched && (pin == PIN_WIRE_SCL || pin == PIN_WIRE_SDA)) {
+            touched = true;
+            endsWhenTouched = wire->ends();
+        }
+        if (pin == PIN_WIRE_SCL && hostDrivesLow(pin) && clocks) {
+            clocks--;
+        }
+    }
+
+    bool pullsLow(uint8_t pin) {
+        return pin == PIN_WIRE_SDA && clocks;
+    }
+};
+
+static void checkRecover(MLX90615* mlx, TwoWire* wire) {
+    StuckSda slave(wire, 3);
+    hostAttachPins(&slave);
+    uint16_t ends = wire->ends();
+    uint16_t begins = wire->begins();
+    CHECK_EQ(mlx->recover(), 0);
+    CHECK_EQ(slave.endsWhenTouched, ends + 1);
+    CHECK_EQ(slave.clocks, 0);
+    // Pins released, pulled up, and Wire begun again
+    CHECK_EQ(hostPinMode(PIN_WIRE_SCL), INPUT_PULLUP);
+    CHECK_EQ(hostPinMode(PIN_WIRE_SDA), INPUT_PULLUP);
+    CHECK_EQ(digitalRead(PIN_WIRE_SCL), HIGH);
+    CHECK_EQ(wire->begins(), begins + 1);
+
+    // Never released: recover() gives up after I2C_RECOVER_CLOCKS pulses
+    slave.clocks = 255;
+    CHECK_EQ(mlx->recover(), -2);
+    CHECK_EQ(slave.clocks, 255 - I2C_RECOVER_CLOCKS);
+    hostAttachPins(0);
+}
+
+static void testWireRecover() {
+    SimI2cMaster bus;
+    SimWire wire(&bus);
+    TwiMaster twi(wire);
+    MLX90615 wired(MLX90615_DefaultAddr, &wire);
+    MLX90615 mlx(MLX90615_DefaultAddr, &twi);
+
+    checkRecover(&wired, &wire);
+    uint16_t value;
+    mlx.readReg(MLX90615_OBJECT_TEMPERATURE, &value);
+    checkRecover(&mlx, &wire);
+}
+
+int main() {
+    TEST_RUN(testWireReadReg);
+    TEST_RUN(testWireWriteReg);
+    TEST_RUN(testWireNak);
+    TEST_RUN(testWireRelease);
+    TEST_RUN(testTwiMaster);
+    TEST_RUN(testTwiMasterAsync);
+    TEST_RUN(testWireWake);
+    TEST_RUN(testWireRecover);
+    return TEST_RESULT();
+}